@@ -0,0 +1,57 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "AssetRegistry.h"
+
+#include "HeriswapGame.h"
+
+#include "base/Log.h"
+
+#include <cstdio>
+
+TextureRef AssetRegistry::leafTexture[8];
+float AssetRegistry::leafRotation[8];
+hash_t AssetRegistry::herissonAnimation[8];
+
+EffectRef AssetRegistry::desaturate;
+TextureRef AssetRegistry::soundOn, AssetRegistry::soundOff;
+
+SoundRef AssetRegistry::menuSound, AssetRegistry::deleteSound, AssetRegistry::rollbackSound;
+
+void AssetRegistry::Load() {
+    LOGI("\t- Load assets refs...");
+    for (int type=0; type<8; type++) {
+        leafTexture[type] = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(type, &leafRotation[type]));
+
+        char tmp[32];
+        snprintf(tmp, 32, "herisson_%d", type + 1);
+        herissonAnimation[type] = Murmur::RuntimeHash(tmp);
+    }
+
+    desaturate = theRenderingSystem.effectLibrary.load("desaturate.fs");
+    soundOn = theRenderingSystem.loadTextureFile("sound_on");
+    soundOff = theRenderingSystem.loadTextureFile("sound_off");
+
+    menuSound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+    deleteSound = theSoundSystem.loadSoundFile("audio/son_monte.ogg");
+    rollbackSound = theSoundSystem.loadSoundFile("audio/son_descend.ogg");
+}
@@ -0,0 +1,49 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "systems/AnimationSystem.h"
+#include "systems/RenderingSystem.h"
+#include "systems/SoundSystem.h"
+
+/* Refs of the assets used while playing, resolved once at startup: gameplay code
+ * indexes these instead of hashing names again and again. */
+class AssetRegistry {
+    public:
+        // RenderingSystem and SoundSystem must be ready
+        static void Load();
+
+        // by leaf type
+        static TextureRef leafTexture[8];
+        static float leafRotation[8];
+        // herisson animation, by bonus type
+        static hash_t herissonAnimation[8];
+
+        static EffectRef desaturate;
+        static TextureRef soundOn, soundOff;
+
+        // buttons
+        static SoundRef menuSound;
+        // leaves removal, and cancelled swap
+        static SoundRef deleteSound, rollbackSound;
+};
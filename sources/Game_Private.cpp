@@ -22,6 +22,7 @@
 #include "HeriswapGame.h"
 #include "Game_Private.h"
 
+#include "AssetRegistry.h"
 #include "DepthLayer.h"
 
 #include "modes/GameModeManager.h"
@@ -60,14 +61,11 @@ PrivateData::PrivateData(HeriswapGame* game, GameContext* context, SuccessManage
     soundButton = theEntityManager.CreateEntityFromTemplate("general/soundButton");
 
     if (storageAPI->isOption("sound", "on"))
-        RENDERING(soundButton)->texture = theRenderingSystem.loadTextureFile("sound_on");
+        RENDERING(soundButton)->texture = AssetRegistry::soundOn;
     else
-        RENDERING(soundButton)->texture = theRenderingSystem.loadTextureFile("sound_off");
+        RENDERING(soundButton)->texture = AssetRegistry::soundOff;
 
-    for (int i=0; i<3; ++i) {
-        Entity e = theEntityManager.CreateEntityFromTemplate("general/cloud");
-        theBackgroundSystem.initCloud(e, i);
-    }
+    theBackgroundSystem.createClouds(1);
 
     for(auto it : mode2Manager)
         it.second->Setup();
@@ -30,10 +30,17 @@
 #include "systems/MusicSystem.h"
 
 #include "modes/GameModeManager.h"
+#include "sim/GameRules.h"
+#include "sim/SessionLog.h"
+#include "systems/HeriswapGridSystem.h"
 
 #include "Jukebox.h"
+#include "util/BenchmarkDriver.h"
 #include "util/FaderHelper.h"
 #include "util/GameCenterAPIHelper.h"
+#include "util/SoakDriver.h"
+#include "util/SwapLatency.h"
+#include "util/TouchEventQueue.h"
 
 class PrivateData {
     public:
@@ -67,13 +74,24 @@ class PrivateData {
      std::vector<int> bestScores;
 
     // animations timing
-    struct {
-        float deletion;
-        float swap;
-        float fall;
-        float haveToAddLeavesInGrid;
-        float replaceGrid;
-    } timing;
+    GameRules::Timing timing;
+
+    // current game, as it will be submitted for verification
+    SessionLog session;
+
+    // leaves created ahead of SpawnScene (during the fall or the level change), it grows them
+    std::vector<Feuille> spawnAhead;
+
+    // scripted game playing (benchmarks)
+    BenchmarkDriver benchmark;
+    // back to back bot games (leaks hunting)
+    SoakDriver soak;
+
+    // first finger events, posted by the platform (HeriswapGame::touchEvent) or
+    // sampled each frame, consumed by UserInputScene
+    TouchEventQueue touchEvents;
+    // from the finger to the leaves removal, per difficulty
+    SwapLatency swapLatency;
 
     // hum hum
     bool newGame;
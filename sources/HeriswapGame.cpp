@@ -21,14 +21,18 @@
 
 
 #include "HeriswapGame.h"
+#include "AssetRegistry.h"
 
 #include "CombinationMark.h"
 #include "DepthLayer.h"
 #include "Game_Private.h"
 #include "util/ScoreStorageProxy.h"
+#include "util/Random.h"
 #include "systems/HeriswapGridSystem.h"
 #include "systems/TwitchSystem.h"
 #include "systems/BackgroundSystem.h"
+#include "systems/CellTweenSystem.h"
+#include "systems/DesaturationSystem.h"
 
 #include "modes/NormalModeManager.h"
 #include "modes/Go100SecondsModeManager.h"
@@ -105,51 +109,67 @@ static const float scale = 0.95f;
 static const float size = (10 - 2 * offset) / 8.f;
 
 // grid: [48, 302] -> [752, 1006]  in gimp
-glm::vec2 HeriswapGame::GridCoordsToPosition(int i, int j, int gridSize) {
-    float startX = PlacementHelper::GimpXToScreen(48);
-    float startY = PlacementHelper::GimpYToScreen(1006);
-    float size = PlacementHelper::GimpWidthToScreen((752 - 48) / gridSize);
+static const float cellWidthCoeff[] = {
+    0.74f / 0.8f, 0.74f / 0.8f,
+    0.62f / 0.8f, 0.62f / 0.8f,
+    0.52f / 0.8f, 0.52f / 0.8f,
+    0.38f / 0.8f, 0.38f / 0.8f,
+};
 
-    return glm::vec2(
-        startX + (i + 0.5) * size,
-        startY + (j + 0.5) * size);
+const HeriswapGame::GridGeometry& HeriswapGame::Geometry(int gridSize) {
+    static GridGeometry geometries[9];
+    LOGF_IF(gridSize <= 0 || gridSize > 8, "Invalid grid size: " << gridSize);
+
+    GridGeometry& g = geometries[gridSize];
+    if (g.gridSize != gridSize || g.screen != PlacementHelper::ScreenSize) {
+        g.gridSize = gridSize;
+        g.screen = PlacementHelper::ScreenSize;
+        g.cell = PlacementHelper::GimpWidthToScreen((752 - 48) / gridSize);
+        g.invCell = 1 / g.cell;
+        g.origin = glm::vec2(
+            PlacementHelper::GimpXToScreen(48) + 0.5 * g.cell,
+            PlacementHelper::GimpYToScreen(1006) + 0.5 * g.cell);
+        for (int t=0; t<8; t++) {
+            g.cellSize[t] = glm::vec2(g.cell * cellWidthCoeff[t], g.cell);
+        }
+    }
+    return g;
+}
+
+glm::vec2 HeriswapGame::GridCoordsToPosition(int i, int j, int gridSize) {
+    const GridGeometry& g = Geometry(gridSize);
+    return g.origin + glm::vec2(i, j) * g.cell;
 }
 
 glm::vec2 HeriswapGame::CellSize(int gridSize, int cellType) {
-    float y = PlacementHelper::GimpWidthToScreen((752 - 48) / gridSize);
-    float coeff = 1;
-    switch (cellType) {
-        case 0:
-        case 1:
-            coeff = 0.74f / 0.8f;
-            break;
-        case 2:
-        case 3:
-            coeff = 0.62f / 0.8f;
-            break;
-        case 4:
-        case 5:
-            coeff = 0.52f / 0.8f;
-            break;
-        case 6:
-        case 7:
-            coeff = 0.38f / 0.8f;
-            break;
-    }
-    return glm::vec2(y * coeff, y);
+    const GridGeometry& g = Geometry(gridSize);
+    if (cellType < 0 || cellType >= 8)
+        return glm::vec2(g.cell);
+    return g.cellSize[cellType];
+}
+
+bool HeriswapGame::PositionToGridCoords(const glm::vec2& pos, int gridSize, float tolerance, int& i, int& j) {
+    const GridGeometry& g = Geometry(gridSize);
+    const glm::vec2 p = (pos - g.origin) * g.invCell;
+    i = glm::clamp((int)glm::floor(p.x + 0.5f), 0, gridSize - 1);
+    j = glm::clamp((int)glm::floor(p.y + 0.5f), 0, gridSize - 1);
+    const glm::vec2 d = pos - (g.origin + glm::vec2(i, j) * g.cell);
+    return glm::dot(d, d) < tolerance;
 }
 
 float HeriswapGame::CellContentScale() {
     return scale;
 }
 
-HeriswapGame::HeriswapGame() : Game() {
+HeriswapGame::HeriswapGame() : Game(), datas(0) {
 }
 
 HeriswapGame::~HeriswapGame() {
     HeriswapGridSystem::DestroyInstance();
     TwitchSystem::DestroyInstance();
     BackgroundSystem::DestroyInstance();
+    CellTweenSystem::DestroyInstance();
+    DesaturationSystem::DestroyInstance();
     delete datas;
 }
 
@@ -182,6 +202,8 @@ void HeriswapGame::sacInitFromGameThread() {
     HeriswapGridSystem::CreateInstance();
     TwitchSystem::CreateInstance();
     BackgroundSystem::CreateInstance();
+    CellTweenSystem::CreateInstance();
+    DesaturationSystem::CreateInstance();
 
     LOGI("\t- Init sceneStateMachine...");
     sceneStateMachine.registerState(Scene::CountDown, Scene::CreateCountDownSceneHandler(this));
@@ -203,8 +225,8 @@ void HeriswapGame::sacInitFromGameThread() {
 
     Color::nameColor(Color(3.0f / 255.0f, 99.0f / 255.f, 71.0f / 255.f), HASH("green", 0x615465c4));
 
-    LOGI("\t- Load FX...");
-    theRenderingSystem.effectLibrary.load("desaturate.fs");
+    LOGI("\t- Load FX, textures and sounds...");
+    AssetRegistry::Load();
 
     LOGI("\t- Load animations...");
     // Animations
@@ -254,6 +276,7 @@ void HeriswapGame::sacInitFromGameThread() {
 
     SCROLLING(datas->sky)->displaySize = glm::vec2(TRANSFORM(datas->sky)->size.x * 1.01,
                                                    TRANSFORM(datas->sky)->size.y);
+    theDesaturationSystem.tagScrolling(datas->sky, DesaturationSystem::Decor);
 
     datas->faderHelper.init(camera);
 
@@ -275,6 +298,8 @@ void HeriswapGame::sacInitFromGameThread() {
     #endif
 
     modeMenuIsInNameInput = false;
+    datas->benchmark.load();
+    datas->soak.load();
     LOGI("HeriswapGame initialisation done.");
 }
 
@@ -391,6 +416,12 @@ void HeriswapGame::backPressed() {
     }
 }
 
+void HeriswapGame::touchEvent(const TouchEvent& event) {
+    // nowhere to queue them before sacInitFromGameThread
+    if (datas)
+        datas->touchEvents.post(event);
+}
+
 void HeriswapGame::togglePause(bool activate) {
     LOGT("TODO: Must be called from Game thread");
 
@@ -404,6 +435,9 @@ void HeriswapGame::togglePause(bool activate) {
 
 void HeriswapGame::tick(float dt) {
     PROFILE("Game", "Tick", BeginEvent);
+    dt *= datas->soak.timeScale;
+    const float frameStart = TimeUtil::GetTime();
+    const Scene::Enum frameScene = sceneStateMachine.getCurrentState();
     sceneStateMachine.update(dt);
     // update state
     //datas->newState = datas->state2Manager[datas->state]->Update(dt);
@@ -414,10 +448,17 @@ void HeriswapGame::tick(float dt) {
         case Scene::Delete:
         case Scene::Fall:
         case Scene::Spawn:
-        case Scene::LevelChanged:
+        case Scene::LevelChanged: {
             //updating gamemode
-            datas->mode2Manager[datas->mode]->GameUpdate(dt, sceneStateMachine.getCurrentState());
+            GameModeManager* mgr = datas->mode2Manager[datas->mode];
+            const float clock = mgr->time;
+            mgr->GameUpdate(dt, sceneStateMachine.getCurrentState());
+            // only the clock moves during GameUpdate (gains are applied by scenes)
+            datas->session.advance(mgr->time - clock);
+            datas->benchmark.advance(mgr->time - clock);
+            datas->soak.advance(mgr->time - clock);
             break;
+        }
         default:
         break;
     }
@@ -470,10 +511,10 @@ void HeriswapGame::tick(float dt) {
         theSoundSystem.mute = !theSoundSystem.mute;
         theMusicSystem.toggleMute(theSoundSystem.mute);
         if (!theSoundSystem.mute) {
-            SOUND(datas->soundButton)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
-            RENDERING(datas->soundButton)->texture = theRenderingSystem.loadTextureFile("sound_on");
+            SOUND(datas->soundButton)->sound = AssetRegistry::menuSound;
+            RENDERING(datas->soundButton)->texture = AssetRegistry::soundOn;
         } else {
-            RENDERING(datas->soundButton)->texture = theRenderingSystem.loadTextureFile("sound_off");
+            RENDERING(datas->soundButton)->texture = AssetRegistry::soundOff;
         }
     }
 
@@ -565,6 +606,12 @@ void HeriswapGame::tick(float dt) {
     theHeriswapGridSystem.Update(dt);
     theTwitchSystem.Update(dt);
     theBackgroundSystem.Update(dt);
+    // cells animations stop with the game
+    if (sceneStateMachine.getCurrentState() != Scene::Pause)
+        theCellTweenSystem.Update(dt);
+
+    if (datas->benchmark.active())
+        datas->benchmark.frames.record(frameScene, TimeUtil::GetTime() - frameStart);
 }
 
 struct SavedState {
@@ -673,6 +720,8 @@ void HeriswapGame::loadGameState(const uint8_t* in, int ) {
     /* restore entities */
     theEntityManager.deserialize(in, ss.entitySize);
     in += ss.entitySize;
+    theHeriswapGridSystem.RecoverParkedCells();
+    theBackgroundSystem.RecoverClouds();
 
     /* restore state machine */
     sceneStateMachine.deserialize(in, ss.stateMachineSize);
@@ -685,6 +734,10 @@ void HeriswapGame::loadGameState(const uint8_t* in, int ) {
     datas->mode2Manager[datas->mode]->restoreInternalState(in, ss.gameStateSize);
     in += ss.gameStateSize;
 
+    // generator state isn't saved: this game can no longer be replayed
+    theHeriswapGridSystem.rng.seed((uint32_t)Random::Int(1, 0x7fffffff));
+    datas->session.invalidate();
+
     // if game wasn't pause before stopping, force pause
     if (!ss.gameWasPaused) {
         sceneStateMachine.update(0);
@@ -727,6 +780,51 @@ float HeriswapGame::cellTypeToRotation(int type) {
     return rotations[type];
 }
 
+Entity HeriswapGame::createCell(Feuille& f, bool assignGridPos) {
+    Entity e = theHeriswapGridSystem.AcquireCell();
+
+    TRANSFORM(e)->position = GridCoordsToPosition(f.X, f.Y, theHeriswapGridSystem.GridSize);
+    TRANSFORM(e)->z = DL_Cell + Random::Float(0.f, 1.f) * 0.001f;
+    RenderingComponent* rc = RENDERING(e);
+    rc->show = true;
+    rc->color.a = 1;
+    rc->effectRef = DefaultEffectRef;
+
+    TRANSFORM(e)->size = glm::vec2(0.f);
+    setCellType(e, f.type);
+    if (assignGridPos) {
+        HERISWAPGRID(e)->i = f.X;
+        HERISWAPGRID(e)->j = f.Y;
+    }
+    return e;
+}
+
+void HeriswapGame::setCellType(Entity e, int type) {
+    HERISWAPGRID(e)->type = type;
+    ADSR(e)->idleValue = CellSize(theHeriswapGridSystem.GridSize, type).x * CellContentScale();
+    RENDERING(e)->texture = AssetRegistry::leafTexture[type];
+    TRANSFORM(e)->rotation = AssetRegistry::leafRotation[type];
+}
+
+void HeriswapGame::retypeGrid(const Board& board, std::vector<Entity>& byPos, std::vector<Feuille>& leaves) {
+    theHeriswapGridSystem.MapPositions(byPos);
+    const int size = board.size();
+    for (int j=0; j<size; j++) {
+        for (int i=0; i<size; i++) {
+            Feuille f = {i, j, byPos[i + j * size], board.get(i, j)};
+            if (f.entity == 0) {
+                f.entity = createCell(f, true);
+            } else {
+                TWITCH(f.entity)->speed = 0;
+                setCellType(f.entity, f.type);
+                TRANSFORM(f.entity)->size = glm::vec2(0.f);
+                RENDERING(f.entity)->color.a = 1;
+            }
+            leaves.push_back(f);
+        }
+    }
+}
+
 bool HeriswapGame::shouldPlayPiano() {
     // are we near to beat the next score ?
     if (datas->scoreboardRankInSight == 0 || datas->mode != Normal)
@@ -757,30 +855,8 @@ void HeriswapGame::stopInGameMusics() {
 }
 
 void HeriswapGame::setupGameProp() {
-    if (datas->mode == Go100Seconds) {
-        datas->timing.deletion = 0.2f;
-        datas->timing.swap = 0.03f;
-        datas->timing.fall = 0.1f;
-        datas->timing.haveToAddLeavesInGrid = 0.2f;
-        datas->timing.replaceGrid = 0.5f;
-    } else {
-        //update anim times
-        Difficulty difficulty = theHeriswapGridSystem.sizeToDifficulty();
-        if (difficulty == DifficultyEasy) {
-            datas->timing.deletion = 0.6f;
-            datas->timing.swap = 0.14f;
-            datas->timing.fall = 0.30f;
-            datas->timing.haveToAddLeavesInGrid = 0.40f;
-            datas->timing.replaceGrid = 1.f;
-        } else {
-            datas->timing.deletion = 0.3f;
-            datas->timing.swap = 0.07f;
-            datas->timing.fall = 0.15f;
-            datas->timing.haveToAddLeavesInGrid = 0.40f;
-            datas->timing.replaceGrid = 1.f;
-        }
-    }
-
+    //update anim times
+    datas->timing = GameRules::timing(datas->mode, theHeriswapGridSystem.sizeToDifficulty());
 
     std::stringstream ss;
     ss << "where mode = " << datas->mode << " and difficulty = " << theHeriswapGridSystem.sizeToDifficulty();
@@ -804,6 +880,11 @@ void HeriswapGame::setupGameProp() {
 void HeriswapGame::prepareNewGame() {
     //for count down in 2nd mode
     datas->newGame = true;
+    // every draw changing the outcome comes from this seed, so the game can be replayed
+    uint32_t seed = datas->benchmark.active() ? datas->benchmark.script.seed : (uint32_t)Random::Int(1, 0x7fffffff);
+    theHeriswapGridSystem.rng.seed(seed);
+    datas->session.begin(seed, datas->mode, theHeriswapGridSystem.sizeToDifficulty());
+    theHeriswapGridSystem.ReserveCells();
     // call Enter before starting fade-in
     datas->mode2Manager[datas->mode]->Enter();
     datas->mode2Manager[datas->mode]->UiUpdate(0);
@@ -37,6 +37,8 @@
 #include "systems/RenderingSystem.h"
 #include "systems/HeriswapGridSystem.h"
 
+#include "util/TouchEventQueue.h"
+
 #include <glm/glm.hpp>
 
 #include <string>
@@ -65,16 +67,39 @@ class HeriswapGame : public Game {
 
     void backPressed() override;
     bool willConsumeBackEvent() override;
+    /* Platform input thread: first finger event as it happened, 'position' in world
+     * coordinates and 'time' on the TimeUtil clock. Frames with such events don't
+     * sample theTouchInputManager (see TouchEventQueue) */
+    void touchEvent(const TouchEvent& event);
 
     bool isLandscape() const override { return false; }
 
         static bool inGameState(Scene::Enum state);
 		static bool pausableState(Scene::Enum state);
+		/* Grid placement for one grid size, computed once per screen size */
+		struct GridGeometry {
+			int gridSize;
+			glm::vec2 screen;
+			// center of cell (0,0), cell side and its inverse
+			glm::vec2 origin;
+			float cell, invCell;
+			glm::vec2 cellSize[8];
+		};
+		static const GridGeometry& Geometry(int gridSize);
 		static glm::vec2 GridCoordsToPosition(int i, int j, int s);
 		static glm::vec2 CellSize(int gridSize, int cellType);
+		/* Cell under 'pos' if its center is closer than sqrt('tolerance'), false otherwise */
+		static bool PositionToGridCoords(const glm::vec2& pos, int gridSize, float tolerance, int& i, int& j);
 		static float CellContentScale();
 		static const char* cellTypeToTextureNameAndRotation(int type, float* rotation);
 		static float cellTypeToRotation(int type);
+		/* New leaf entity for 'f', with a null size (it grows up when spawning) */
+		static Entity createCell(Feuille& f, bool assignGridPos);
+		/* Give leaf 'e' a new type: texture, rotation and grown size follow */
+		static void setCellType(Entity e, int type);
+		/* Turn the leaves in place into 'board' (same size), all shrunk to a null size,
+		 * and append them to 'leaves' so they grow up again. 'byPos' is a scratch buffer */
+		static void retypeGrid(const Board& board, std::vector<Entity>& byPos, std::vector<Feuille>& leaves);
 
         void prepareNewGame();
 		void setupGameProp();
@@ -21,7 +21,11 @@
 
 #include "GameModeManager.h"
 
+#include "AssetRegistry.h"
+
 #include "DepthLayer.h"
+#include "systems/CellTweenSystem.h"
+#include "systems/DesaturationSystem.h"
 #include "systems/TwitchSystem.h"
 #include "systems/HeriswapGridSystem.h"
 
@@ -90,13 +94,12 @@ void GameModeManager::LoadHerissonTexture(int type) {
     LOGW_IF(type > 8, "type > 8");
     LOGW_IF(type < 1, "type < 1");
     type = (type > 8 ? 8 : (type < 1 ? 1 : type));
-    char tmp[32];
-    snprintf(tmp, 32, "herisson_%d", type);
-    ANIMATION(herisson)->name = Murmur::RuntimeHash(tmp);
+    ANIMATION(herisson)->name = AssetRegistry::herissonAnimation[type - 1];
 }
 
 void GameModeManager::Setup() {
     herisson = theEntityManager.CreateEntityFromTemplate("gamemode/herisson");
+    theDesaturationSystem.tag(herisson, DesaturationSystem::Decor);
 
     branch = theEntityManager.CreateEntityFromTemplate("gamemode/branch");
 
@@ -108,6 +111,7 @@ void GameModeManager::Setup() {
     SCROLLING(decor2nd)->images.push_back(HASH("decor2nd_3", 0xb93314de));
     SCROLLING(decor2nd)->images.push_back(HASH("decor2nd_2", 0xc2edcdae));
     SCROLLING(decor2nd)->images.push_back(HASH("decor2nd_1", 0xe8c9a7d4));
+    theDesaturationSystem.tagScrolling(decor2nd, DesaturationSystem::Decor);
 
     decor1er = theEntityManager.CreateEntityFromTemplate("gamemode/decor1er");
     TRANSFORM(decor1er)->size.x = PlacementHelper::ScreenSize.x;
@@ -116,6 +120,7 @@ void GameModeManager::Setup() {
     SCROLLING(decor1er)->images.push_back(HASH("decor1er_1", 0x5ba415d2));
     SCROLLING(decor1er)->images.push_back(HASH("decor1er_2", 0x68f8263e));
     SCROLLING(decor1er)->images.push_back(HASH("decor1er_3", 0x4d7b9af));
+    theDesaturationSystem.tagScrolling(decor1er, DesaturationSystem::Decor);
 
     fillVec();
 
@@ -127,7 +132,7 @@ void GameModeManager::Setup() {
         debugEntities[2*i] = theEntityManager.CreateEntity(HASH("debug/Entities", 0x15df1b7c));
         ADD_COMPONENT(debugEntities[2*i], Rendering);
         ADD_COMPONENT(debugEntities[2*i], Transformation);
-        RENDERING(debugEntities[2*i])->texture = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(i, 0));
+        RENDERING(debugEntities[2*i])->texture = AssetRegistry::leafTexture[i];
         TRANSFORM(debugEntities[2*i])->z = DL_DebugLayer;
         TRANSFORM(debugEntities[2*i])->size = glm::vec2((float)PlacementHelper::GimpWidthToScreen(80));
 
@@ -155,9 +160,9 @@ void GameModeManager::showGameDecor(bool onlyBg) {
         uiHelper.show();
 
     // delete leaves
-    for (unsigned int az=0;az<branchLeaves.size();az++) {
-        RENDERING(branchLeaves[az].e)->show = !onlyBg;
-    }
+    branchLeaves.forEach([onlyBg] (const BranchLeaf& l) -> void {
+        RENDERING(l.e)->show = !onlyBg;
+    });
 }
 
 void GameModeManager::Enter() {
@@ -185,10 +190,14 @@ void GameModeManager::Exit() {
     uiHelper.game->stopInGameMusics();
     uiHelper.hide();
 
+    // leaves may be deleted: nothing must animate them anymore
+    theCellTweenSystem.clear();
+    // game over hint
+    theDesaturationSystem.clear();
     // delete leaves
-    for (unsigned int az=0;az<branchLeaves.size();az++) {
-        theEntityManager.DeleteEntity(branchLeaves[az].e);
-    }
+    branchLeaves.forEach([this] (const BranchLeaf& l) -> void {
+        releaseLeave(l.e);
+    });
     branchLeaves.clear();
     theHeriswapGridSystem.DeleteAll();
     PROFILE("GameModeManager", "Exit", InstantEvent);
@@ -207,9 +216,17 @@ Entity GameModeManager::createAndAddLeave(int type, const glm::vec2& position, f
     ADD_COMPONENT(e, Transformation);
     ADD_COMPONENT(e, Rendering);
     ADD_COMPONENT(e, Twitch);
-    RENDERING(e)->texture = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(type, 0));
-    RENDERING(e)->show = true;
     RENDERING(e)->flags = RenderingFlags::NonOpaque;
+    theDesaturationSystem.tag(e, DesaturationSystem::Decor);
+    setupLeave(e, type, position, rotation);
+    return e;
+}
+
+void GameModeManager::setupLeave(Entity e, int type, const glm::vec2& position, float rotation) {
+    RENDERING(e)->texture = AssetRegistry::leafTexture[type];
+    // new leaves show up in color, even while the level change desaturates the decor
+    RENDERING(e)->effectRef = DefaultEffectRef;
+    RENDERING(e)->show = true;
 
     TRANSFORM(e)->size = HeriswapGame::CellSize(8, type) * HeriswapGame::CellContentScale();
 
@@ -217,14 +234,30 @@ Entity GameModeManager::createAndAddLeave(int type, const glm::vec2& position, f
     TRANSFORM(e)->rotation = rotation;
 
     TRANSFORM(e)->z = glm::lerp(DL_LeafMin, DL_LeafMax, Random::Float(0.f, 1.f));
+}
 
+std::vector<Entity> GameModeManager::leavesPool;
+
+Entity GameModeManager::acquireLeave(int type, const glm::vec2& position, float rotation) {
+    if (leavesPool.empty())
+        return createAndAddLeave(type, position, rotation);
+    Entity e = leavesPool.back();
+    leavesPool.pop_back();
+    *TWITCH(e) = TwitchComponent();
+    setupLeave(e, type, position, rotation);
     return e;
 }
 
-void GameModeManager::generateLeaves(int* nb, int type) {
-    for (unsigned int i=0;i<branchLeaves.size();i++)
-        theEntityManager.DeleteEntity(branchLeaves[i].e);
+void GameModeManager::releaseLeave(Entity e) {
+    RENDERING(e)->show = false;
+    TWITCH(e)->speed = 0;
+    leavesPool.push_back(e);
+}
 
+void GameModeManager::generateLeaves(int* nb, int type) {
+    branchLeaves.forEach([this] (const BranchLeaf& l) -> void {
+        releaseLeave(l.e);
+    });
     branchLeaves.clear();
     fillVec();
 
@@ -238,36 +271,89 @@ void GameModeManager::generateLeaves(int* nb, int type) {
             pos.x -= PlacementHelper::GimpXToScreen(0) - -PlacementHelper::ScreenSize.x*0.5f;
 
             BranchLeaf bl;
-            bl.e = createAndAddLeave(j, pos, posBranch[rnd].rot);
+            bl.e = acquireLeave(j, pos, posBranch[rnd].rot);
             bl.type = j;
-            branchLeaves.push_back(bl);
+            branchLeaves.add(bl);
 
-            posBranch.erase(posBranch.begin()+rnd);
+            // order doesn't matter
+            posBranch[rnd] = posBranch.back();
+            posBranch.pop_back();
         }
     }
-    //shuffle pour éviter que les mêmes couleurs soient à coté dans la liste :
-    //ça sert en 100 tiles, pour que les feuilles supprimées soient d'abord ttes les
-    //rouges, ensuites les jaunes etc..
-    std::random_shuffle(branchLeaves.begin(), branchLeaves.end());
+    //pas besoin de mélanger : les feuilles supprimées sont tirées au hasard (cf BranchLeaves::pick)
 }
 
 void GameModeManager::deleteLeaves(unsigned int type, int nb) {
+    for (; nb > 0; nb--) {
+        Entity e = branchLeaves.remove(type);
+        if (!e)
+            break;
+        releaseLeave(e);
+    }
+}
+
+GameModeManager::BranchLeaves::BranchLeaves() {
+    clear();
+}
+
+void GameModeManager::BranchLeaves::add(const BranchLeaf& leaf) {
+    std::vector<BranchLeaf>& bucket = buckets[leaf.type];
+    bucket.push_back(leaf);
+    // keep picked leaves at the end
+    if (doomed[leaf.type])
+        std::swap(bucket.back(), bucket[bucket.size() - 1 - doomed[leaf.type]]);
+    total++;
+}
+
+void GameModeManager::BranchLeaves::clear() {
+    for (int t=0; t<8; t++) {
+        buckets[t].clear();
+        doomed[t] = 0;
+    }
+    total = 0;
+}
+
+bool GameModeManager::BranchLeaves::pick(unsigned int type, BranchLeaf& out) {
+    int t = type, index;
     if (type == ~0u) {
-        while (branchLeaves.size()>0 && nb) {
-            theEntityManager.DeleteEntity(branchLeaves[0].e);
-            branchLeaves.erase(branchLeaves.begin());
-            nb--;
-        }
+        int available = 0;
+        for (int k=0; k<8; k++)
+            available += buckets[k].size() - doomed[k];
+        if (available == 0)
+            return false;
+        index = Random::Int(0, available - 1);
+        for (t=0; index >= (int)buckets[t].size() - doomed[t]; t++)
+            index -= buckets[t].size() - doomed[t];
     } else {
-        for (unsigned int i=0; nb>0 && i<branchLeaves.size(); i++) {
-            if (type == branchLeaves[i].type) {
-                theEntityManager.DeleteEntity(branchLeaves[i].e);
-                branchLeaves.erase(branchLeaves.begin()+i);
-                nb--;
-                i--;
-            }
-        }
+        const int available = buckets[t].size() - doomed[t];
+        if (available == 0)
+            return false;
+        index = Random::Int(0, available - 1);
     }
+    std::vector<BranchLeaf>& bucket = buckets[t];
+    doomed[t]++;
+    std::swap(bucket[index], bucket[bucket.size() - doomed[t]]);
+    out = bucket[bucket.size() - doomed[t]];
+    return true;
+}
+
+Entity GameModeManager::BranchLeaves::remove(unsigned int type) {
+    int t = type;
+    if (type == ~0u) {
+        for (t=0; t<8 && !doomed[t]; t++) ;
+    }
+    if (t == 8 || !doomed[t]) {
+        BranchLeaf picked;
+        if (!pick(type, picked))
+            return 0;
+        t = picked.type;
+    }
+    std::vector<BranchLeaf>& bucket = buckets[t];
+    Entity e = bucket.back().e;
+    bucket.pop_back();
+    doomed[t]--;
+    total--;
+    return e;
 }
 
 void GameModeManager::fillVec() {
@@ -325,11 +411,7 @@ int GameModeManager::saveInternalState(uint8_t** out) {
     MEMPCPY(uint8_t*, ptr, &points, sizeof(points));
     MEMPCPY(uint8_t*, ptr, &bonus, sizeof(bonus));
     for (int i=0; i<8; i++) {
-        uint8_t count = 0;
-        for (unsigned int j=0; j<branchLeaves.size(); j++) {
-            if (branchLeaves[j].type == (unsigned int)i)
-                count++;
-        }
+        uint8_t count = branchLeaves.count(i);
         MEMPCPY(uint8_t*, ptr, &count, sizeof(count));
     }
     return s;
@@ -371,9 +453,5 @@ void GameModeManager::toggleDebugDisplay() {
 #endif
 
 int GameModeManager::countBranchLeavesOfType(int t) const {
-    int count = 0;
-    for (unsigned int i=0; i<branchLeaves.size(); i++) {
-        count += (t == (int)branchLeaves[i].type);
-    }
-    return count;
+    return branchLeaves.count(t);
 }
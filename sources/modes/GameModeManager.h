@@ -25,21 +25,38 @@
 
 #include "api/StorageAPI.h"
 #include "HeriswapGame.h"
+#include "GameMode.h"
 #include "InGameUiHelper.h"
 #include "SuccessManager.h"
 
-enum GameMode {
-	Normal = 0,
-	TilesAttack,
-	Go100Seconds
-};
-
 class GameModeManager {
 	public:
 		struct BranchLeaf {
 			Entity e;
 			unsigned int type;
 		};
+		/* Branch leaves, one bucket per type. Leaves picked by WillScore are moved
+		 * at the end of their bucket (the last 'doomed[t]' ones) and are removed first */
+		struct BranchLeaves {
+			BranchLeaves();
+			void add(const BranchLeaf& leaf);
+			void clear();
+			int count(int type) const { return buckets[type].size(); }
+			int size() const { return total; }
+			/* Pick a random leaf of 'type' (~0u: any type) not picked yet. False if none */
+			bool pick(unsigned int type, BranchLeaf& out);
+			/* Remove a leaf of 'type' (~0u: any type), picked ones first. 0 if none */
+			Entity remove(unsigned int type);
+			template<typename F> void forEach(F f) const {
+				for (int t=0; t<8; t++)
+					for (unsigned int i=0; i<buckets[t].size(); i++)
+						f(buckets[t][i]);
+			}
+
+			std::vector<BranchLeaf> buckets[8];
+			int doomed[8];
+			int total;
+		};
 		struct Render {
 			glm::vec2 v;
 			float rot;
@@ -91,6 +108,9 @@ class GameModeManager {
 		void updateHerisson(float dt, float obj, float herissonSpeed);
 		void deleteLeaves(unsigned int type, int nb);
 		Entity createAndAddLeave(int type, const glm::vec2& position, float rotation);
+		// branch leaves come from a pool shared by every mode, kept between games and levels
+		Entity acquireLeave(int type, const glm::vec2& position, float rotation);
+		void releaseLeave(Entity e);
 
 	public:
 		// game params
@@ -99,7 +119,7 @@ class GameModeManager {
         Entity sky;
 		Entity herisson;
 		//feuilles de l'arbre
-		std::vector<BranchLeaf> branchLeaves;
+		BranchLeaves branchLeaves;
 
 		// display elements
 		InGameUiHelper uiHelper;
@@ -114,4 +134,6 @@ class GameModeManager {
 	private:
 		std::vector<Render> posBranch;
 		void fillVec();
+		static void setupLeave(Entity e, int type, const glm::vec2& position, float rotation);
+		static std::vector<Entity> leavesPool;
 };
@@ -21,10 +21,12 @@
 
 #include "Go100SecondsModeManager.h"
 
+#include "AssetRegistry.h"
 #include "DepthLayer.h"
 #include "CombinationMark.h"
 
 #include "systems/HeriswapGridSystem.h"
+#include "sim/GameRules.h"
 
 #include "base/PlacementHelper.h"
 #include "base/EntityManager.h"
@@ -82,18 +84,20 @@ void Go100SecondsGameModeManager::initPosition() {
 #define RATE 1
 void Go100SecondsGameModeManager::Enter() {
 	time = 0;
-	limit = 100;
+	limit = GameRules::Go100SecondsLimit;
 	points = 0;
 	squallGo = false;
 	squallDuration = 0.f;
-	bonus = Random::Int(0, theHeriswapGridSystem.Types-1);
+	bonus = theHeriswapGridSystem.rng.Int(0, theHeriswapGridSystem.Types-1);
 
 	initPosition();
 
 	generateLeaves(0, 8);
 
-	for (unsigned int i = 0; i < squallLeaves.size();  i++)
-		RENDERING(squallLeaves[i])->texture = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(bonus, &TRANSFORM(squallLeaves[i])->rotation));
+	for (unsigned int i = 0; i < squallLeaves.size();  i++) {
+		RENDERING(squallLeaves[i])->texture = AssetRegistry::leafTexture[bonus];
+		TRANSFORM(squallLeaves[i])->rotation = AssetRegistry::leafRotation[bonus];
+	}
 
 	TEXT(uiHelper.scoreProgress)->flags |= TextComponent::IsANumberBit;
 
@@ -112,7 +116,8 @@ void Go100SecondsGameModeManager::squall() {
 		Entity  e = squallLeaves[i];
 		TRANSFORM(e)->position = glm::vec2(Random::Float(minX, maxX), Random::Float(minY, maxY));
 		TRANSFORM(e)->size = HeriswapGame::CellSize(8, 0) * HeriswapGame::CellContentScale() * Random::Float(0.35f,1.2f);
-		RENDERING(e)->texture = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(bonus, &TRANSFORM(e)->rotation));
+		RENDERING(e)->texture = AssetRegistry::leafTexture[bonus];
+		TRANSFORM(e)->rotation = AssetRegistry::leafRotation[bonus];
 		RENDERING(e)->show = true;
 
 		Force force;
@@ -147,16 +152,14 @@ void Go100SecondsGameModeManager::GameUpdate(float dt, Scene::Enum state) {
 		//if the central leaf is next to the herisson, change his bonus
 		if (TRANSFORM(squallLeaves[0])->position.x <= TRANSFORM(herisson)->position.x) {
 			// LoadHerissonTexture(bonus+1);
-            char tmp[32];
-            snprintf(tmp, 32, "herisson_%d", bonus + 1);
-			ANIMATION(herisson)->name = Murmur::RuntimeHash(tmp);
+			ANIMATION(herisson)->name = AssetRegistry::herissonAnimation[bonus];
 			// RENDERING(herisson)->texture = theRenderingSystem.loadTextureFile(c->anim[0]);
 		}
 		//make the tree leaves grow ...
-		for (unsigned int i = 0; i < branchLeaves.size(); i++) {
-			TRANSFORM(branchLeaves[i].e)->size =
-				HeriswapGame::CellSize(8, bonus) * HeriswapGame::CellContentScale() * glm::min(squallDuration, 1.f);
-		}
+		const glm::vec2 size = HeriswapGame::CellSize(8, bonus) * HeriswapGame::CellContentScale() * glm::min(squallDuration, 1.f);
+		branchLeaves.forEach([&size] (const BranchLeaf& l) -> void {
+			TRANSFORM(l.e)->size = size;
+		});
 		//check if every leaves has gone...
 		bool ended = true;
 		for (unsigned int i = 0 ; i < squallLeaves.size() ; i++) {
@@ -180,11 +183,12 @@ void Go100SecondsGameModeManager::GameUpdate(float dt, Scene::Enum state) {
 		//oh noes, no longer leaf on tree ! Give me new one
 		if (branchLeaves.size() == 0) {
 			//Ok, but first u'll have a new bonus
-			bonus = Random::Int(0, theHeriswapGridSystem.Types-1);
+			bonus = theHeriswapGridSystem.rng.Int(0, theHeriswapGridSystem.Types-1);
 			//And leaves aren't magic, they need to grow ... be patient.
 			generateLeaves(0, 8);
-			for (unsigned int i = 0; i < branchLeaves.size(); i++)
-				TRANSFORM(branchLeaves[i].e)->size = glm::vec2(0.f);
+			branchLeaves.forEach([] (const BranchLeaf& l) -> void {
+				TRANSFORM(l.e)->size = glm::vec2(0.f);
+			});
 			//The squall will make them grow
 			squall();
 		}
@@ -198,14 +202,8 @@ float Go100SecondsGameModeManager::GameProgressPercent() {
 
 void Go100SecondsGameModeManager::UiUpdate(float dt) {
 	//Score
-	{
-	std::stringstream a;
-	a.precision(0);
-	//~not enable currently
-	//~a << rank << ". ";
-	a << std::fixed << points;
-	TEXT(uiHelper.scoreProgress)->text = a.str();
-	}
+	//~not enable currently: rank
+	uiHelper.setScore(points);
 
 	updateHerisson(dt, time, 0);
 
@@ -223,25 +221,10 @@ void Go100SecondsGameModeManager::UiUpdate(float dt) {
 }
 
 void Go100SecondsGameModeManager::ScoreCalc(int nb, unsigned int type) {
-	Difficulty diff = theHeriswapGridSystem.sizeToDifficulty();
+	const bool isBonus = (type == bonus);
 
-	float score = 10 * nb * nb * nb * nb;
-
-	switch (diff) {
-		case DifficultyEasy: break;
-		case DifficultyMedium: score *= 2; break;
-		case DifficultyHard: score *= 4; break;
-		default:
-			LOGE("Unhandled difficulty: '" << diff << "'");
-	}
-
-	if (type == bonus) {
-		score *= 2;
-		deleteLeaves(~0u, 2*nb);
-	} else {
-		deleteLeaves(~0u, nb);
-	}
-	points += score;
+	deleteLeaves(~0u, GameRules::go100SecondsLeavesToRemove(nb, isBonus));
+	points += GameRules::go100SecondsPoints(nb, theHeriswapGridSystem.sizeToDifficulty(), isBonus);
 
 }
 
@@ -250,11 +233,11 @@ void Go100SecondsGameModeManager::TogglePauseDisplay(bool paused) {
 }
 
 void Go100SecondsGameModeManager::WillScore(int count, int, std::vector<BranchLeaf>& LeavesToDelete) {
-    int nb = glm::min((int)branchLeaves.size(), count);
-    for (unsigned int i=0; nb>0 && i<branchLeaves.size(); i++) {
-		CombinationMark::markCellInCombination(branchLeaves[i].e);
-        LeavesToDelete.push_back(branchLeaves[i]);
-        nb--;
+    int nb = glm::min(branchLeaves.size(), count);
+    BranchLeaf leaf;
+    for (; nb>0 && branchLeaves.pick(~0u, leaf); nb--) {
+		CombinationMark::markCellInCombination(leaf.e);
+        LeavesToDelete.push_back(leaf);
     }
 }
 
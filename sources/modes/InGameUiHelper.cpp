@@ -21,6 +21,8 @@
 
 #include "InGameUiHelper.h"
 
+#include "AssetRegistry.h"
+
 #include <base/PlacementHelper.h>
 #include <base/EntityManager.h>
 
@@ -48,6 +50,9 @@ void InGameUiHelper::build() {
 
     scoreProgress = theEntityManager.CreateEntityFromTemplate("general/scoreProgress");
 
+    scoreRun.init(game->gameThreadContext->assetAPI, scoreProgress, "typo");
+    levelRun.init(game->gameThreadContext->assetAPI, smallLevel, "gdtypo");
+
     built = true;
 }
 
@@ -55,16 +60,39 @@ void InGameUiHelper::show() {
     if (!built)
         return;
 
-    TEXT(smallLevel)->show = true;
+    levelRun.show(true);
     RENDERING(pauseButton)->show = true;
-    TEXT(scoreProgress)->show = true;
+    scoreRun.show(true);
     BUTTON(pauseButton)->enabled=true;
+
+    // new game: the mode may format the score as a time where the previous one
+    // wrote a number, a cached value must not skip the first write
+    scoreText.reset();
+    levelText.reset();
+}
+
+void InGameUiHelper::setScore(unsigned int value) {
+    if (scoreText.setUnsigned(value))
+        scoreRun.setText(scoreText.c_str());
+}
+
+void InGameUiHelper::setScoreTime(float seconds) {
+    if (scoreText.setTime(seconds))
+        scoreRun.setText(scoreText.c_str());
+}
+
+void InGameUiHelper::setLevel(unsigned int value) {
+    if (levelText.setUnsigned(value))
+        levelRun.setText(levelText.c_str());
 }
 
 void InGameUiHelper::update(float) {
+    scoreRun.update();
+    levelRun.update();
+
     // handle button
     if (BUTTON(pauseButton)->clicked) {
-        SOUND(pauseButton)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+        SOUND(pauseButton)->sound = AssetRegistry::menuSound;
         game->togglePause(true);
     }
 }
@@ -72,15 +100,17 @@ void InGameUiHelper::update(float) {
 void InGameUiHelper::hide() {
     if (!built)
         return;
-    TEXT(smallLevel)->show = false;
+    levelRun.show(false);
     RENDERING(pauseButton)->show = false;
     BUTTON(pauseButton)->enabled = false;
-    TEXT(scoreProgress)->show = false;
+    scoreRun.show(false);
 }
 
 void InGameUiHelper::destroy() {
     if (!built)
         return;
+    scoreRun.destroy();
+    levelRun.destroy();
     theEntityManager.DeleteEntity(smallLevel);
     theEntityManager.DeleteEntity(pauseButton);
     theEntityManager.DeleteEntity(scoreProgress);
@@ -25,6 +25,9 @@
 
 #include "HeriswapGame.h"
 
+#include "util/DigitRun.h"
+#include "util/HudText.h"
+
 class InGameUiHelper {
 	public:
 		InGameUiHelper();
@@ -35,10 +38,18 @@ class InGameUiHelper {
 		void hide();
 		void destroy();
 
+		// TextComponents are only written when the displayed text changes
+		void setScore(unsigned int value);
+		void setScoreTime(float seconds);
+		void setLevel(unsigned int value);
+
 	Entity smallLevel;
 	Entity pauseButton;
 	Entity scoreProgress;
 	HeriswapGame* game;
 	private:
 		bool built;
+		HudText scoreText, levelText;
+		// drawn instead of scoreProgress and smallLevel texts
+		DigitRun scoreRun, levelRun;
 };
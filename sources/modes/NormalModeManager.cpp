@@ -23,6 +23,7 @@
 
 #include "CombinationMark.h"
 #include "systems/HeriswapGridSystem.h"
+#include "sim/GameRules.h"
 
 #include "base/PlacementHelper.h"
 #include "base/EntityManager.h"
@@ -34,7 +35,6 @@
 #include "systems/TextSystem.h"
 #include "systems/TransformationSystem.h"
 
-#include "util/Random.h"
 
 #include <glm/glm.hpp>
 
@@ -65,12 +65,12 @@ void NormalGameModeManager::Setup() {
 
 void NormalGameModeManager::Enter() {
     PROFILE("NormalGameModeManager", "Enter", BeginEvent);
-    limit = 45;
+    limit = GameRules::normalLimit(1);
     time = 0;
     points = 0;
     level = 1;
-    bonus = Random::Int(0, theHeriswapGridSystem.Types-1);
-    for (int i=0;i<theHeriswapGridSystem.Types;i++) remain[i]=3;
+    bonus = theHeriswapGridSystem.rng.Int(0, theHeriswapGridSystem.Types-1);
+    for (int i=0;i<theHeriswapGridSystem.Types;i++) remain[i]=GameRules::normalLeavesToRemove(level);
     nextHerissonSpeed = 1;
     levelMoveDuration = 0;
     helpAvailable = true;
@@ -135,19 +135,10 @@ void NormalGameModeManager::UiUpdate(float dt) {
     }
 
     //Score
-    {
-    std::stringstream a;
-    a.precision(0);
-    a << std::fixed << points;
-    TEXT(uiHelper.scoreProgress)->text = a.str();
-    }
+    uiHelper.setScore(points);
 
     //Level
-    {
-    std::stringstream a;
-    a << level;
-    TEXT(uiHelper.smallLevel)->text = a.str();
-    }
+    uiHelper.setLevel(level);
 
     if (levelMoveDuration > 0) {
         updateHerisson(dt, time / limit, nextHerissonSpeed);
@@ -189,17 +180,15 @@ int NormalGameModeManager::levelToLeaveToDelete(int, int nb, int initialLeaveCou
 }
 
 static float timeGain(int nb, int, float time) {
-    return glm::min(time, 2.f*nb/theHeriswapGridSystem.GridSize);
+    return GameRules::normalTimeGain(nb, theHeriswapGridSystem.GridSize, time);
 }
 
 void NormalGameModeManager::WillScore(int count, int type, std::vector<BranchLeaf>& out) {
     int nb = levelToLeaveToDelete(type, count, level+2, level+2 - remain[type], countBranchLeavesOfType(type));
-    for (unsigned int i=0; nb>0 && i<branchLeaves.size(); i++) {
-        if (type == (int)branchLeaves[i].type) {
-            CombinationMark::markCellInCombination(branchLeaves[i].e);
-            out.push_back(branchLeaves[i]);
-            nb--;
-        }
+    BranchLeaf leaf;
+    for (; nb>0 && branchLeaves.pick(type, leaf); nb--) {
+        CombinationMark::markCellInCombination(leaf.e);
+        out.push_back(leaf);
     }
 
     // move background during delete/spawn sequence (+ fall ?)
@@ -221,10 +210,7 @@ void NormalGameModeManager::WillScore(int count, int type, std::vector<BranchLea
 }
 
 void NormalGameModeManager::ScoreCalc(int nb, unsigned int type) {
-    if (type == bonus)
-        points += 10*level*2*nb*nb*nb/6;
-    else
-        points += 10*level*nb*nb*nb/6;
+    points += GameRules::normalPoints(nb, level, type == bonus);
 
     deleteLeaves(type, levelToLeaveToDelete(type, nb, level+2, level+2 - remain[type], countBranchLeavesOfType(type)));
     remain[type] -= nb;
@@ -243,14 +229,14 @@ void NormalGameModeManager::ScoreCalc(int nb, unsigned int type) {
 void NormalGameModeManager::startLevel(int lvl) {
     level = lvl;
 
-    limit = glm::max(45.0f - (level - 1.0f), 10.0f);
+    limit = GameRules::normalLimit(level);
 
     successMgr->sLevel10(lvl);
 
     LOGI("New level: '" << lvl << "'");
 
     for (int i=0;i<theHeriswapGridSystem.Types;i++)
-        remain[i] = 2+level;
+        remain[i] = GameRules::normalLeavesToRemove(level);
 
     if (level < 10)  {
         helpAvailable = true;
@@ -260,7 +246,7 @@ void NormalGameModeManager::startLevel(int lvl) {
 
     // put hedgehog back on first animation position
     // c->ind = 0;
-    bonus = Random::Int(0, theHeriswapGridSystem.Types-1);
+    bonus = theHeriswapGridSystem.rng.Int(0, theHeriswapGridSystem.Types-1);
     LoadHerissonTexture(bonus+1);
     SCROLLING(decor1er)->speed = 0;
 }
@@ -282,7 +268,7 @@ bool NormalGameModeManager::LevelUp() {
     if (match) {
         successMgr->sLevel1For2K(level, points);
 
-        time -= glm::min(20 * 8.f / theHeriswapGridSystem.GridSize, time);
+        time -= GameRules::normalLevelUpTimeGain(theHeriswapGridSystem.GridSize, time);
 
         PROFILE("NormalGameModeManager", "changeLevel", InstantEvent);
 
@@ -24,6 +24,7 @@
 #include "DepthLayer.h"
 #include "CombinationMark.h"
 #include "systems/HeriswapGridSystem.h"
+#include "sim/GameRules.h"
 
 #include "base/PlacementHelper.h"
 #include "base/EntityManager.h"
@@ -32,11 +33,9 @@
 #include "systems/TextSystem.h"
 #include "systems/TransformationSystem.h"
 
-#include "util/Random.h"
 
 #include <glm/glm.hpp>
 
-#include <iomanip>
 #include <sstream>
 
 TilesAttackGameModeManager::TilesAttackGameModeManager(HeriswapGame* game, SuccessManager* successMgr, StorageAPI* sAPI) : GameModeManager(game, successMgr, sAPI) {
@@ -52,12 +51,7 @@ void TilesAttackGameModeManager::Setup() {
 void TilesAttackGameModeManager::initPosition() {
 	pts.clear();
 	pts.push_back(glm::vec2(0, 0));
-	if (theHeriswapGridSystem.sizeToDifficulty() == DifficultyEasy)
-		limit = 30;
-	else if (theHeriswapGridSystem.sizeToDifficulty() == DifficultyMedium)
-		limit = 100;
-	else
-		limit = 100;
+	limit = GameRules::tilesAttackLimit(theHeriswapGridSystem.sizeToDifficulty());
 	pts.push_back(glm::vec2(limit, 1));//need limit leaves to end game
 }
 
@@ -65,7 +59,7 @@ void TilesAttackGameModeManager::Enter() {
 	time = 0;
 	leavesDone = 0;
 	points = 0;
-	bonus =  Random::Int(0, theHeriswapGridSystem.Types-1);
+	bonus = theHeriswapGridSystem.rng.Int(0, theHeriswapGridSystem.Types-1);
 	succNoGridReset=false;
 	initPosition();
 
@@ -101,27 +95,9 @@ float TilesAttackGameModeManager::GameProgressPercent() {
 
 void TilesAttackGameModeManager::UiUpdate(float dt) {
 	//Score
-	{
-	std::stringstream a;
-	a.precision(0);
-	if (leavesDone>limit)
-		a << std::fixed << (unsigned)0;
-	else
-		a << std::fixed << limit - leavesDone;
-
-	TEXT(uiHelper.smallLevel)->text = a.str();
-	}
+	uiHelper.setLevel(leavesDone > limit ? 0 : limit - leavesDone);
 	//Temps
-	{
-	std::stringstream a;
-
-	int minute = ((int)time) / 60;
-	int seconde= ((int)time) % 60;
-	int tenthsec = (time - minute * 60 - seconde) * 10;
-	if (minute) a << minute << ':';
-	a << std::setw(2) << std::setfill('0') << seconde << '.' << std::setw(1) << tenthsec << " s";
-	TEXT(uiHelper.scoreProgress)->text = a.str();
-	}
+	uiHelper.setScoreTime(time);
 
 	updateHerisson(dt, leavesDone, 0);
 
@@ -167,15 +143,11 @@ int TilesAttackGameModeManager::levelToLeaveToDelete(int leavesMaxSize, int limi
 }
 
 void TilesAttackGameModeManager::ScoreCalc(int nb, unsigned int type) {
-	if (type == bonus) {
-		points += 10*2*nb*nb*nb/6;
-		deleteLeaves(~0u, levelToLeaveToDelete(6*8, limit, 2*nb, leavesDone));
-		leavesDone+=2*nb;
-	} else {
-		points += 10*nb*nb*nb/6;
-		deleteLeaves(~0u, levelToLeaveToDelete(6*8, limit, nb, leavesDone));
-		leavesDone+=nb;
-	}
+	const bool isBonus = (type == bonus);
+	const int done = GameRules::tilesAttackLeavesDone(nb, isBonus);
+	points += GameRules::tilesAttackPoints(nb, isBonus);
+	deleteLeaves(~0u, levelToLeaveToDelete(6*8, limit, done, leavesDone));
+	leavesDone += done;
 	successMgr->sRainbow(type);
 
 	successMgr->sBonusToExcess(type, bonus, nb);
@@ -187,10 +159,10 @@ void TilesAttackGameModeManager::TogglePauseDisplay(bool paused) {
 
 void TilesAttackGameModeManager::WillScore(int count, int type, std::vector<BranchLeaf>& out) {
     int nb = levelToLeaveToDelete(48, limit, (type == (int)bonus ? count * 2 : count), leavesDone);
-    for (unsigned i=0; nb > 0 && i<branchLeaves.size(); i++) {
-		CombinationMark::markCellInCombination(branchLeaves[i].e);
-        out.push_back(branchLeaves[i]);
-        nb--;
+    BranchLeaf leaf;
+    for (; nb > 0 && branchLeaves.pick(~0u, leaf); nb--) {
+		CombinationMark::markCellInCombination(leaf.e);
+        out.push_back(leaf);
     }
 }
 
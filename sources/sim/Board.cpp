@@ -0,0 +1,340 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "Board.h"
+
+const int Board::Empty;
+
+Board::Board(int size, int t) : nbmin(3) {
+    reset(size, t);
+}
+
+void Board::reset(int size, int t) {
+    gridSize = size;
+    types = t;
+    cells.assign(gridSize * gridSize, Empty);
+}
+
+void Board::clear() {
+    cells.assign(gridSize * gridSize, Empty);
+}
+
+void Board::swap(int i1, int j1, int i2, int j2) {
+    int t = get(i1, j1);
+    set(i1, j1, get(i2, j2));
+    set(i2, j2, t);
+}
+
+int Board::emptyCount() const {
+    int count = 0;
+    for (unsigned i=0; i<cells.size(); i++)
+        count += (cells[i] == Empty);
+    return count;
+}
+
+static bool Intersec(const std::vector<glm::vec2>& v1, const std::vector<glm::vec2>& v2) {
+    for (size_t i = 0; i < v1.size(); ++i) {
+        for (size_t j = 0; j < v2.size(); ++j) {
+            if (v1[i] == v2[j])
+                return true;
+        }
+    }
+    return false;
+}
+
+static Combinais MergeVectors(const Combinais& c1, const Combinais& c2) {
+    Combinais merged = c1;
+    for (size_t i=0; i<c2.points.size(); i++) {
+        bool found = false;
+        for (size_t j=0; !found && j<c1.points.size(); j++)
+            found = (c1.points[j] == c2.points[i]);
+        if (!found)
+            merged.points.push_back(c2.points[i]);
+    }
+    return merged;
+}
+
+std::vector<Combinais> Board::MergeCombination(std::vector<Combinais> combinaisons) {
+    std::vector<Combinais> combinmerged;
+
+    for (size_t i = 0; i < combinaisons.size(); ++i) {
+        int match = -1;
+        for (size_t j = i+1; j < combinaisons.size(); ++j) {
+            if (combinaisons[i].type == combinaisons[j].type && Intersec(combinaisons[i].points, combinaisons[j].points)) {
+                match = j;
+                combinaisons[j] = MergeVectors(combinaisons[i], combinaisons[j]);
+            }
+        }
+        if (match == -1)
+            combinmerged.push_back(combinaisons[i]);
+    }
+    return combinmerged;
+}
+
+std::vector<Combinais> Board::LookForCombination() const {
+    return MergeCombination(LookForLines());
+}
+
+std::vector<Combinais> Board::LookForLines() const {
+    std::vector<Combinais> combinaisons;
+
+    // each line is only reported once, from its first cell
+    for (int i=0; i<gridSize; i++) {
+        int j = 0;
+        while (j < gridSize) {
+            const int type = get(i, j);
+            int k = j + 1;
+            while (k < gridSize && get(i, k) == type)
+                k++;
+            if (type != Empty && k - j >= nbmin) {
+                Combinais c;
+                c.type = type;
+                for (int l=j; l<k; l++)
+                    c.points.push_back(glm::vec2(i, l));
+                combinaisons.push_back(c);
+            }
+            j = k;
+        }
+    }
+    for (int j=0; j<gridSize; j++) {
+        int i = 0;
+        while (i < gridSize) {
+            const int type = get(i, j);
+            int k = i + 1;
+            while (k < gridSize && get(k, j) == type)
+                k++;
+            if (type != Empty && k - i >= nbmin) {
+                Combinais c;
+                c.type = type;
+                for (int l=i; l<k; l++)
+                    c.points.push_back(glm::vec2(l, j));
+                combinaisons.push_back(c);
+            }
+            i = k;
+        }
+    }
+    return combinaisons;
+}
+
+bool Board::PositionsInPatterns(int type, const int* vType) {
+    return (
+    //horizontal combis ?
+       (type == vType[0] && type == vType[1])
+    || (type == vType[1] && type == vType[2])
+    || (type == vType[2] && type == vType[3])
+    //vertical combis ?
+    || (type == vType[4] && type == vType[5])
+    || (type == vType[5] && type == vType[6])
+    || (type == vType[6] && type == vType[7])
+    );
+}
+
+bool Board::GridPosIsInCombination(int i, int j, int type) const {
+    if (type == Empty)
+        return false;
+
+    const int vType[8] = {
+        get(i-2, j), get(i-1, j), get(i+1, j), get(i+2, j),
+        get(i, j-2), get(i, j-1), get(i, j+1), get(i, j+2)
+    };
+    return PositionsInPatterns(type, vType);
+}
+
+int Board::getSwapped(int i, int j, const BoardSwap& s) const {
+    if (i == s.i1 && j == s.j1)
+        return get(s.i2, s.j2);
+    if (i == s.i2 && j == s.j2)
+        return get(s.i1, s.j1);
+    return get(i, j);
+}
+
+bool Board::SwappedPosIsInCombination(int i, int j, const BoardSwap& s) const {
+    const int type = getSwapped(i, j, s);
+    if (type == Empty)
+        return false;
+
+    const int vType[8] = {
+        getSwapped(i-2, j, s), getSwapped(i-1, j, s), getSwapped(i+1, j, s), getSwapped(i+2, j, s),
+        getSwapped(i, j-2, s), getSwapped(i, j-1, s), getSwapped(i, j+1, s), getSwapped(i, j+2, s)
+    };
+    return PositionsInPatterns(type, vType);
+}
+
+bool Board::SwapCreatesCombination(int i1, int j1, int i2, int j2) const {
+    if (!isValid(i1, j1) || !isValid(i2, j2))
+        return false;
+    // the board is only read: it can be shared between threads
+    const BoardSwap s = {i1, j1, i2, j2};
+    return SwappedPosIsInCombination(i1, j1, s) || SwappedPosIsInCombination(i2, j2, s);
+}
+
+bool Board::StillCombinations() const {
+    if (!LookForCombination().empty())
+        return true;
+
+    for (int i=0; i<gridSize; i++) {
+        for (int j=0; j<gridSize; j++) {
+            if (SwapCreatesCombination(i, j, i+1, j) || SwapCreatesCombination(i, j, i, j+1))
+                return true;
+        }
+    }
+    return false;
+}
+
+void Board::SwapsCreatingCombination(std::vector<BoardSwap>& out) const {
+    for (int i=0; i<gridSize; i++) {
+        for (int j=0; j<gridSize; j++) {
+            if (SwapCreatesCombination(i, j, i+1, j)) {
+                BoardSwap s = {i, j, i+1, j};
+                out.push_back(s);
+            }
+            if (SwapCreatesCombination(i, j, i, j+1)) {
+                BoardSwap s = {i, j, i, j+1};
+                out.push_back(s);
+            }
+        }
+    }
+}
+
+void Board::Remove(const std::vector<Combinais>& combinaisons) {
+    for (unsigned c=0; c<combinaisons.size(); c++) {
+        for (unsigned p=0; p<combinaisons[c].points.size(); p++) {
+            const glm::vec2& pt = combinaisons[c].points[p];
+            set(pt.x, pt.y, Empty);
+        }
+    }
+}
+
+std::vector<BoardFall> Board::TileFall() const {
+    std::vector<BoardFall> result;
+
+    for (int i=0; i<gridSize; i++) {
+        int toY = 0;
+        for (int j=0; j<gridSize; j++) {
+            if (get(i, j) == Empty)
+                continue;
+            if (j != toY) {
+                BoardFall f = {i, j, toY};
+                result.push_back(f);
+            }
+            toY++;
+        }
+    }
+    return result;
+}
+
+void Board::ApplyFall(const std::vector<BoardFall>& falls) {
+    // falls are sorted bottom to top in each column, so targets are always free
+    for (unsigned k=0; k<falls.size(); k++) {
+        const BoardFall& f = falls[k];
+        set(f.x, f.toY, get(f.x, f.fromY));
+        set(f.x, f.fromY, Empty);
+    }
+}
+
+float Board::FallClearance(const std::vector<BoardFall>& falls, int x, int y) {
+    float clearance = 0;
+    for (unsigned k=0; k<falls.size(); k++) {
+        const BoardFall& f = falls[k];
+        if (f.x != x || f.fromY < y)
+            continue;
+        // the leaf goes from fromY to toY (< y) at constant speed
+        const float t = (f.fromY - (y - 0.5f)) / (f.fromY - f.toY);
+        if (t > clearance)
+            clearance = t;
+    }
+    return (clearance < 1) ? clearance : 1;
+}
+
+void Board::FillTheBlank(SeededRandom& random, std::vector<BoardCell>& out) {
+    for (int i=0; i<gridSize; i++) {
+        for (int j=0; j<gridSize; j++) {
+            //oh ! it misses someone on (i,j)
+            if (get(i, j) != Empty)
+                continue;
+
+            //get a type which doesn't create a combi with its neighboors
+            int type, ite = 0;
+            do {
+                type = random.Int(0, types-1);
+                ite++;
+            } while (GridPosIsInCombination(i, j, type) && ite<5000);
+
+            set(i, j, type);
+            BoardCell c = {i, j, type};
+            out.push_back(c);
+        }
+    }
+}
+
+void Board::RemoveCombinations(SeededRandom& random, std::vector<BoardCell>& out) {
+    std::vector<Combinais> c;
+    unsigned int ite = 0;
+    //remove direct combinations but keep combinations to do (give up at 100 try)
+    do {
+        c = LookForCombination();
+        // change type from cells in combi
+        for(unsigned int i=0; i<c.size(); i++) {
+            const glm::vec2& p = c[i].points[random.Int(0, c[i].points.size()-1)];
+            int type, iter = 0;
+            do {
+                type = random.Int(0, types-1);
+                iter++;
+            } while (GridPosIsInCombination(p.x, p.y, type) && iter < 100);
+            set(p.x, p.y, type);
+            BoardCell cell = {(int)p.x, (int)p.y, type};
+            out.push_back(cell);
+        }
+        ite++;
+    } while(!c.empty() && ite<100);
+}
+
+int Board::difficultyToSize(Difficulty diff) {
+    if (diff == DifficultyEasy)
+        return 5;
+    else if (diff == DifficultyMedium)
+        return 6;
+    else
+        return 8;
+}
+
+Difficulty Board::sizeToDifficulty(int size) {
+    if (size == 5)
+        return DifficultyEasy;
+    else if (size == 6)
+        return DifficultyMedium;
+    else
+        return DifficultyHard;
+}
+
+Difficulty Board::nextDifficulty(Difficulty diff) {
+    switch (diff) {
+        case DifficultyEasy :
+            return DifficultyMedium;
+        case DifficultyMedium :
+            return DifficultyHard;
+        case DifficultyHard :
+            return DifficultyEasy;
+        default:
+            break;
+    }
+    //should never happen
+    return DifficultyEasy;
+}
@@ -0,0 +1,141 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "sim/SeededRandom.h"
+
+//medium is after hard because it would have ruined ppl's score using the game before adding the medium difficulty on android
+enum Difficulty {
+    SelectAllDifficulty = -1,
+    DifficultyEasy = 0,
+    DifficultyMedium = 2,
+    DifficultyHard = 1
+};
+
+struct Combinais {
+    std::vector<glm::vec2> points;
+    int type;
+};
+
+struct BoardCell {
+    int x, y;
+    int type;
+};
+
+struct BoardFall {
+    int x;
+    int fromY, toY;
+};
+
+struct BoardSwap {
+    int i1, j1;
+    int i2, j2;
+};
+
+/* Leaves types only, no entity: this is the grid as the rules see it.
+ * HeriswapGridSystem snapshots itself into a Board whenever it needs to generate
+ * types, so that headless tools (replay, bots...) draw exactly the same leaves. */
+class Board {
+    public:
+        static const int Empty = -1;
+
+        Board(int size = 8, int types = 8);
+
+        void reset(int size, int types);
+        void clear();
+
+        int size() const { return gridSize; }
+        int typeCount() const { return types; }
+
+        bool isValid(int i, int j) const {
+            return (i>=0 && j>=0 && i<gridSize && j<gridSize);
+        }
+        int get(int i, int j) const {
+            return isValid(i, j) ? cells[j * gridSize + i] : Empty;
+        }
+        void set(int i, int j, int type) {
+            cells[j * gridSize + i] = type;
+        }
+        void swap(int i1, int j1, int i2, int j2);
+
+        int emptyCount() const;
+
+        // bytes used by this board, including its cells
+        size_t memoryUsage() const { return sizeof(*this) + cells.capacity() * sizeof(int); }
+
+        /* Return the merged list of actual combinations (no switch needed) */
+        std::vector<Combinais> LookForCombination() const;
+
+        /* Every line of at least nbmin same leaves, not merged yet */
+        std::vector<Combinais> LookForLines() const;
+
+        /* Is a leaf of type 'type' in (i,j) part of a combination with its neighbours ? */
+        bool GridPosIsInCombination(int i, int j, int type) const;
+
+        /* Does switching (i1,j1) and (i2,j2) create a combination ? */
+        bool SwapCreatesCombination(int i1, int j1, int i2, int j2) const;
+
+        /* return true if there is still at least 1 combi by switching 2 cells */
+        bool StillCombinations() const;
+
+        /* Append every switch of 2 neighbours creating a combination to 'out' */
+        void SwapsCreatingCombination(std::vector<BoardSwap>& out) const;
+
+        /* Empty every cell of the combinations */
+        void Remove(const std::vector<Combinais>& combinaisons);
+
+        /* Leaves fall if nothing below them, without modifying the board */
+        std::vector<BoardFall> TileFall() const;
+        void ApplyFall(const std::vector<BoardFall>& falls);
+        /* Fraction of the fall animation after which cell (x,y) is free: every leaf
+         * falling through it is at least half a cell below */
+        static float FallClearance(const std::vector<BoardFall>& falls, int x, int y);
+
+        /* Give a type to every empty cell, avoiding direct combinations. New cells are appended to 'out' */
+        void FillTheBlank(SeededRandom& random, std::vector<BoardCell>& out);
+
+        /* Retype one cell of each direct combination until there is none left (give up at 100 try).
+         * Whether a combination to do remains isn't checked: callers test StillCombinations().
+         * Changed cells are appended to 'out' */
+        void RemoveCombinations(SeededRandom& random, std::vector<BoardCell>& out);
+
+        /* Return combinaisons without twice the same point */
+        static std::vector<Combinais> MergeCombination(std::vector<Combinais> combinaisons);
+
+        static int difficultyToSize(Difficulty diff);
+        static Difficulty sizeToDifficulty(int size);
+        static Difficulty nextDifficulty(Difficulty diff);
+
+        int nbmin;
+
+    private:
+        static bool PositionsInPatterns(int type, const int* vType);
+        // type in (i,j) as if the cells of 's' were switched
+        int getSwapped(int i, int j, const BoardSwap& s) const;
+        bool SwappedPosIsInCombination(int i, int j, const BoardSwap& s) const;
+
+        int gridSize, types;
+        std::vector<int> cells;
+};
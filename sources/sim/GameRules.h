@@ -0,0 +1,150 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "modes/GameMode.h"
+#include "sim/Board.h"
+
+#include <glm/glm.hpp>
+
+/* Scoring and timing constants shared by the game mode managers and the headless
+ * simulation: anything that changes a score must be computed here. */
+namespace GameRules {
+    // animations timing
+    struct Timing {
+        float deletion;
+        float swap;
+        float fall;
+        float haveToAddLeavesInGrid;
+        float replaceGrid;
+    };
+
+    inline Timing timing(GameMode mode, Difficulty difficulty) {
+        Timing t;
+        if (mode == Go100Seconds) {
+            t.deletion = 0.2f;
+            t.swap = 0.03f;
+            t.fall = 0.1f;
+            t.haveToAddLeavesInGrid = 0.2f;
+            t.replaceGrid = 0.5f;
+        } else if (difficulty == DifficultyEasy) {
+            t.deletion = 0.6f;
+            t.swap = 0.14f;
+            t.fall = 0.30f;
+            t.haveToAddLeavesInGrid = 0.40f;
+            t.replaceGrid = 1.f;
+        } else {
+            t.deletion = 0.3f;
+            t.swap = 0.07f;
+            t.fall = 0.15f;
+            t.haveToAddLeavesInGrid = 0.40f;
+            t.replaceGrid = 1.f;
+        }
+        return t;
+    }
+
+    // Normal mode clock only runs while the player can play, others never stop
+    inline bool clockRunsDuringResolution(GameMode mode) {
+        return mode != Normal;
+    }
+
+    // how many leaves the branch holds at the start of a game / level
+    const int LeavesPerType = 6;
+
+    ///--------------------- Normal ----------------------------------------------//
+    /* Normal mode balance. Defaults are the shipped values; others are only
+     * used by the tuning tools */
+    struct NormalTuning {
+        NormalTuning() : pointsFactor(10), bonusMultiplier(2), limitStart(45), limitDecay(1), limitMin(10),
+            leavesBase(2), leavesPerLevel(1), timeGainPerLeaf(2), levelUpTimeGain(20) {}
+
+        // points = pointsFactor * level * nb^3 / 6 (times bonusMultiplier)
+        unsigned int pointsFactor, bonusMultiplier;
+        // level time: limitStart - (level-1) * limitDecay, at least limitMin
+        float limitStart, limitDecay, limitMin;
+        // leaves of each type to remove: leavesBase + level * leavesPerLevel
+        int leavesBase, leavesPerLevel;
+        // time given back for a combination of nb leaves (8x8 grid)
+        float timeGainPerLeaf;
+        // time given back on level up (8x8 grid)
+        float levelUpTimeGain;
+    };
+
+    inline unsigned int normalLimit(unsigned int level, const NormalTuning& t = NormalTuning()) {
+        return glm::max(t.limitStart - (level - 1.0f) * t.limitDecay, t.limitMin);
+    }
+
+    inline int normalLeavesToRemove(unsigned int level, const NormalTuning& t = NormalTuning()) {
+        return t.leavesBase + level * t.leavesPerLevel;
+    }
+
+    inline unsigned int normalPoints(int nb, unsigned int level, bool isBonus, const NormalTuning& t = NormalTuning()) {
+        if (isBonus)
+            return t.pointsFactor*level*t.bonusMultiplier*nb*nb*nb/6;
+        else
+            return t.pointsFactor*level*nb*nb*nb/6;
+    }
+
+    inline float normalTimeGain(int nb, int gridSize, float time, const NormalTuning& t = NormalTuning()) {
+        return glm::min(time, t.timeGainPerLeaf*nb/gridSize);
+    }
+
+    inline float normalLevelUpTimeGain(int gridSize, float time, const NormalTuning& t = NormalTuning()) {
+        return glm::min(t.levelUpTimeGain * 8.f / gridSize, time);
+    }
+
+    ///--------------------- TilesAttack -----------------------------------------//
+    inline unsigned int tilesAttackLimit(Difficulty difficulty) {
+        return (difficulty == DifficultyEasy) ? 30 : 100;
+    }
+
+    inline unsigned int tilesAttackPoints(int nb, bool isBonus) {
+        if (isBonus)
+            return 10*2*nb*nb*nb/6;
+        else
+            return 10*nb*nb*nb/6;
+    }
+
+    inline int tilesAttackLeavesDone(int nb, bool isBonus) {
+        return isBonus ? 2*nb : nb;
+    }
+
+    ///--------------------- Go100Seconds ----------------------------------------//
+    const unsigned int Go100SecondsLimit = 100;
+
+    inline float go100SecondsPoints(int nb, Difficulty difficulty, bool isBonus) {
+        float score = 10 * nb * nb * nb * nb;
+
+        switch (difficulty) {
+            case DifficultyMedium: score *= 2; break;
+            case DifficultyHard: score *= 4; break;
+            default: break;
+        }
+        if (isBonus)
+            score *= 2;
+        return score;
+    }
+
+    inline int go100SecondsLeavesToRemove(int nb, bool isBonus) {
+        return isBonus ? 2*nb : nb;
+    }
+}
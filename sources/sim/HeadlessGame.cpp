@@ -0,0 +1,233 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "HeadlessGame.h"
+
+#include <cstdlib>
+
+HeadlessGame::HeadlessGame() : mode(Normal), difficulty(DifficultyEasy), time(0), points(0), bonus(0), limit(0),
+    level(1), leavesDone(0), branchLeaves(0), moves(0), gridResets(0), lastResolutionDuration(0),
+    eliteChoicePending(false) {
+    for (int i=0; i<8; i++)
+        remain[i] = 0;
+}
+
+void HeadlessGame::start(GameMode m, Difficulty diff, uint32_t seed, int startLvl) {
+    mode = m;
+    difficulty = diff;
+    const int size = Board::difficultyToSize(difficulty);
+    grid.reset(size, size);
+    timing = GameRules::timing(mode, difficulty);
+    random.seed(seed);
+
+    time = 0;
+    points = 0;
+    level = 1;
+    leavesDone = 0;
+    branchLeaves = GameRules::LeavesPerType * 8;
+    moves = gridResets = 0;
+    lastResolutionDuration = 0;
+    eliteChoicePending = false;
+
+    // mode managers Enter()
+    switch (mode) {
+        case Normal:
+            limit = GameRules::normalLimit(level, tuning);
+            bonus = random.Int(0, grid.typeCount()-1);
+            for (int i=0; i<grid.typeCount(); i++)
+                remain[i] = GameRules::normalLeavesToRemove(level, tuning);
+            if (startLvl > 1)
+                startLevel(startLvl);
+            break;
+        case TilesAttack:
+            bonus = random.Int(0, grid.typeCount()-1);
+            limit = GameRules::tilesAttackLimit(difficulty);
+            break;
+        case Go100Seconds:
+            limit = GameRules::Go100SecondsLimit;
+            bonus = random.Int(0, grid.typeCount()-1);
+            break;
+    }
+
+    newBoard(true);
+    settle();
+}
+
+size_t HeadlessGame::memoryUsage() const {
+    return sizeof(*this) - sizeof(grid) + grid.memoryUsage() + cells.capacity() * sizeof(BoardCell);
+}
+
+bool HeadlessGame::isOver() const {
+    if (mode == TilesAttack)
+        return leavesDone >= limit;
+    return time >= limit;
+}
+
+bool HeadlessGame::swap(int i1, int j1, int i2, int j2) {
+    if (eliteChoicePending)
+        return false;
+    if (std::abs(i1 - i2) + std::abs(j1 - j2) != 1 || !grid.isValid(i1, j1) || !grid.isValid(i2, j2))
+        return false;
+
+    grid.swap(i1, j1, i2, j2);
+    if (grid.LookForCombination().empty()) {
+        // UserInputScene rolls back
+        grid.swap(i1, j1, i2, j2);
+        return false;
+    }
+    moves++;
+    lastResolutionDuration = 0;
+    settle();
+    return true;
+}
+
+void HeadlessGame::eliteChoice(bool changeDifficulty) {
+    if (!eliteChoicePending)
+        return;
+    eliteChoicePending = false;
+
+    if (changeDifficulty) {
+        difficulty = Board::nextDifficulty(difficulty);
+        const int size = Board::difficultyToSize(difficulty);
+        grid.reset(size, size);
+        timing = GameRules::timing(mode, difficulty);
+        points = 0;
+        startLevel(1);
+    }
+    newBoard(true);
+    settle();
+}
+
+void HeadlessGame::startLevel(unsigned int lvl) {
+    level = lvl;
+    limit = GameRules::normalLimit(level, tuning);
+    for (int i=0; i<grid.typeCount(); i++)
+        remain[i] = GameRules::normalLeavesToRemove(level, tuning);
+    bonus = random.Int(0, grid.typeCount()-1);
+}
+
+bool HeadlessGame::levelUp() {
+    for (int i=0; i<grid.typeCount(); i++) {
+        if (remain[i] != 0)
+            return false;
+    }
+    time -= GameRules::normalLevelUpTimeGain(grid.size(), time, tuning);
+    startLevel(level + 1);
+
+    // LevelChangedScene deletes the whole grid
+    grid.clear();
+    if (level == 10 && difficulty != DifficultyHard)
+        eliteChoicePending = true;
+    else
+        newBoard(true);
+    return true;
+}
+
+void HeadlessGame::newBoard(bool fullGridCleanup) {
+    cells.clear();
+    grid.FillTheBlank(random, cells);
+    // SpawnScene only cleans the grid when it spawns a whole new one from its onPreEnter
+    if (fullGridCleanup && (int)cells.size() == grid.size() * grid.size())
+        grid.RemoveCombinations(random, cells);
+}
+
+void HeadlessGame::scoreCombination(int nb, unsigned int type) {
+    const bool isBonus = (type == bonus);
+
+    switch (mode) {
+        case Normal:
+            points += GameRules::normalPoints(nb, level, isBonus, tuning);
+            remain[type] -= nb;
+            time -= GameRules::normalTimeGain(nb, grid.size(), time, tuning);
+            if (remain[type] < 0)
+                remain[type] = 0;
+            break;
+        case TilesAttack:
+            points += GameRules::tilesAttackPoints(nb, isBonus);
+            leavesDone += GameRules::tilesAttackLeavesDone(nb, isBonus);
+            break;
+        case Go100Seconds:
+            points += GameRules::go100SecondsPoints(nb, difficulty, isBonus);
+            branchLeaves -= GameRules::go100SecondsLeavesToRemove(nb, isBonus);
+            if (branchLeaves < 0)
+                branchLeaves = 0;
+            break;
+    }
+}
+
+float HeadlessGame::spawnDuration(const std::vector<BoardFall>& falls) const {
+    if (falls.empty())
+        return timing.haveToAddLeavesInGrid;
+    // FallScene starts growing each new leaf once the falling ones are out of its way
+    float lastStart = 0;
+    for (unsigned k=0; k<cells.size(); k++)
+        lastStart = glm::max(lastStart, Board::FallClearance(falls, cells[k].x, cells[k].y));
+    return glm::max(0.f, lastStart * timing.fall + timing.haveToAddLeavesInGrid - timing.fall);
+}
+
+void HeadlessGame::settle() {
+    // falls of the last FallScene, the refill can grow during them
+    std::vector<BoardFall> falls;
+    while (true) {
+        // DeleteScene
+        std::vector<Combinais> combinaisons = grid.LookForCombination();
+        if (!combinaisons.empty()) {
+            for (std::vector<Combinais>::reverse_iterator it = combinaisons.rbegin(); it != combinaisons.rend(); ++it)
+                scoreCombination(it->points.size(), it->type);
+            // Go100Seconds: empty branch gets a new bonus
+            if (mode == Go100Seconds && branchLeaves == 0) {
+                bonus = random.Int(0, grid.typeCount()-1);
+                branchLeaves = GameRules::LeavesPerType * 8;
+            }
+            grid.Remove(combinaisons);
+            lastResolutionDuration += timing.deletion;
+
+            // FallScene
+            falls = grid.TileFall();
+            if (!falls.empty()) {
+                grid.ApplyFall(falls);
+                lastResolutionDuration += timing.fall;
+            }
+            continue;
+        }
+
+        // SpawnScene
+        if (grid.emptyCount() > 0) {
+            newBoard(true);
+            lastResolutionDuration += spawnDuration(falls);
+            falls.clear();
+            continue;
+        }
+        if (mode == Normal && levelUp()) {
+            if (eliteChoicePending)
+                return;
+            continue;
+        }
+        if (!grid.StillCombinations()) {
+            grid.clear();
+            newBoard(false);
+            gridResets++;
+            lastResolutionDuration += timing.replaceGrid + timing.haveToAddLeavesInGrid;
+            continue;
+        }
+        // UserInputScene
+        return;
+    }
+}
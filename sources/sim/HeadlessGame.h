@@ -0,0 +1,93 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "modes/GameMode.h"
+#include "sim/Board.h"
+#include "sim/GameRules.h"
+#include "sim/SeededRandom.h"
+
+/* The game rules without any entity, rendering or animation: a swap is resolved
+ * instantly (delete, fall, spawn, level change...), drawing from the same seeded
+ * generator in the same order as the scenes do. Many instances can live side by
+ * side, they share no state. */
+class HeadlessGame {
+    public:
+        HeadlessGame();
+
+        void start(GameMode mode, Difficulty difficulty, uint32_t seed, int startLevel = 1);
+
+        // let the mode clock run (player thinking, animations)
+        void advance(float dt) { time += dt; }
+
+        bool isOver() const;
+
+        /* Swap (i1,j1) and (i2,j2) and resolve everything until the player can play again.
+         * Returns false (and does nothing) if the swap is not allowed. The clock is
+         * not checked: callers decide when the game is over */
+        bool swap(int i1, int j1, int i2, int j2);
+
+        /* Normal mode: level 10 reached on easy/medium, the player must choose
+         * between switching to the next difficulty or keeping on */
+        bool awaitingEliteChoice() const { return eliteChoicePending; }
+        void eliteChoice(bool changeDifficulty);
+
+        const Board& board() const { return grid; }
+
+        // bytes used by this game (the instance and everything it owns)
+        size_t memoryUsage() const;
+
+        GameMode mode;
+        Difficulty difficulty;
+        // Normal mode balance, to be set before start()
+        GameRules::NormalTuning tuning;
+
+        float time;
+        unsigned int points, bonus, limit;
+        unsigned int level;
+        // Normal: leaves still to remove for each type
+        int remain[8];
+        // TilesAttack
+        unsigned int leavesDone;
+        // Go100Seconds: leaves left on the branch
+        int branchLeaves;
+
+        // statistics of the game so far
+        unsigned int moves, gridResets;
+        // minimal animations duration of the last swap resolution
+        float lastResolutionDuration;
+
+    private:
+        void startLevel(unsigned int lvl);
+        bool levelUp();
+        void newBoard(bool fullGridCleanup);
+        void scoreCombination(int nb, unsigned int type);
+        // time the refill in 'cells' adds to the resolution, after 'falls'
+        float spawnDuration(const std::vector<BoardFall>& falls) const;
+        void settle();
+
+        Board grid;
+        SeededRandom random;
+        GameRules::Timing timing;
+        bool eliteChoicePending;
+        std::vector<BoardCell> cells;
+};
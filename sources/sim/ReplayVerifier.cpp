@@ -0,0 +1,131 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ReplayVerifier.h"
+
+#include "sim/HeadlessGame.h"
+
+#include <cmath>
+#include <sstream>
+
+// clock is summed frame by frame in game, and move by move here
+#define TIME_EPSILON 0.05f
+
+static ReplayVerdict reject(ReplayVerdict& v, int eventIndex, const std::string& reason) {
+    v.accepted = false;
+    v.eventIndex = eventIndex;
+    v.reason = reason;
+    return v;
+}
+
+// same as HeadlessGame::isOver, with the clock tolerance either way
+static bool clearlyOver(const HeadlessGame& game) {
+    if (game.mode == TilesAttack)
+        return game.isOver();
+    return game.time - TIME_EPSILON >= game.limit;
+}
+
+static bool maybeOver(const HeadlessGame& game) {
+    if (game.mode == TilesAttack)
+        return game.isOver();
+    return game.time + TIME_EPSILON >= game.limit;
+}
+
+static bool isKnownDifficulty(Difficulty d) {
+    return (d == DifficultyEasy || d == DifficultyMedium || d == DifficultyHard);
+}
+
+ReplayVerdict ReplayVerifier::verify(const SessionLog& session) {
+    ReplayVerdict v;
+    v.accepted = false;
+    v.eventIndex = -1;
+    v.points = 0;
+    v.time = 0;
+    v.level = 1;
+
+    if (!session.valid)
+        return reject(v, -1, "incomplete session");
+    if (session.mode < Normal || session.mode > Go100Seconds)
+        return reject(v, -1, "unknown mode");
+    if (!isKnownDifficulty(session.difficulty))
+        return reject(v, -1, "unknown difficulty");
+    if (session.startLevel != 1 && !(session.mode == Normal && session.startLevel == 10))
+        return reject(v, -1, "invalid start level");
+
+    HeadlessGame game;
+    game.start(session.mode, session.difficulty, session.seed, session.startLevel);
+
+    const bool clockRuns = GameRules::clockRunsDuringResolution(session.mode);
+    // the next move can't happen before the previous one is resolved on screen
+    float minimalGap = 0;
+
+    for (unsigned k=0; k<session.events.size(); k++) {
+        const SessionEvent& e = session.events[k];
+        if (e.elapsed < 0 || std::isnan(e.elapsed))
+            return reject(v, k, "invalid elapsed time");
+
+        if (game.awaitingEliteChoice()) {
+            const bool change = (e.type == SessionEvent::ChangeDifficulty);
+            game.eliteChoice(change);
+            if (change) {
+                game.advance(e.elapsed);
+                continue;
+            }
+        } else if (e.type == SessionEvent::ChangeDifficulty) {
+            return reject(v, k, "unexpected difficulty change");
+        }
+
+        if (clockRuns && e.elapsed + TIME_EPSILON < minimalGap)
+            return reject(v, k, "move faster than animations");
+        game.advance(e.elapsed);
+        if (clearlyOver(game))
+            return reject(v, k, "move after the end of the game");
+        if (!game.swap(e.i1, e.j1, e.i2, e.j2))
+            return reject(v, k, "invalid swap");
+        minimalGap = game.lastResolutionDuration;
+    }
+    game.advance(session.tailElapsed);
+
+    v.points = game.points;
+    v.time = game.time;
+    v.level = (session.mode == Normal) ? game.level : 1;
+
+    const int end = session.events.size();
+    if (session.tailElapsed < 0 || !maybeOver(game))
+        return reject(v, end, "game not finished");
+    if (v.points != session.claimed.points)
+        return reject(v, end, "points mismatch");
+    if (v.level != session.claimed.level)
+        return reject(v, end, "level mismatch");
+    if (std::abs(v.time - session.claimed.time) > TIME_EPSILON)
+        return reject(v, end, "time mismatch");
+
+    v.accepted = true;
+    return v;
+}
+
+std::string ReplayVerifier::verdictToString(const ReplayVerdict& v) {
+    std::stringstream ss;
+    ss << (v.accepted ? "accepted" : "rejected");
+    if (!v.accepted)
+        ss << " event=" << v.eventIndex << " reason='" << v.reason << "'";
+    ss << " points=" << v.points << " time=" << v.time << " level=" << v.level;
+    return ss.str();
+}
@@ -0,0 +1,48 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "sim/SessionLog.h"
+
+#include <string>
+
+struct ReplayVerdict {
+    bool accepted;
+    // why the session was rejected
+    std::string reason;
+    // index of the first rejected event (-1 if none)
+    int eventIndex;
+
+    // what the replay computed
+    unsigned int points;
+    float time;
+    int level;
+};
+
+/* Replays a submitted session on a HeadlessGame and compares the outcome with the
+ * claimed score. Points and level must match exactly; the clock is recomputed for
+ * Normal mode, and checked against the shortest possible animations for the others. */
+namespace ReplayVerifier {
+    ReplayVerdict verify(const SessionLog& session);
+
+    std::string verdictToString(const ReplayVerdict& verdict);
+}
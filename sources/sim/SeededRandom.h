@@ -0,0 +1,62 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+
+/* Small deterministic generator (xorshift64*) for everything that changes the game
+ * outcome (leaves types, bonus). Unlike util/Random it is not shared with cosmetic
+ * code, so a game can be replayed from its seed. */
+class SeededRandom {
+    public:
+        SeededRandom(uint32_t s = 1) { seed(s); }
+
+        void seed(uint32_t s) {
+            // splitmix the seed so that close seeds give unrelated sequences
+            uint64_t z = (uint64_t)s + 0x9E3779B97F4A7C15ull;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            state = z ^ (z >> 31);
+            if (state == 0)
+                state = 0x2545F4914F6CDD1Dull;
+        }
+
+        uint32_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 32);
+        }
+
+        // both bounds are included, like util/Random
+        int Int(int min, int max) {
+            if (max <= min)
+                return min;
+            return min + (int)(next() % (uint32_t)(max - min + 1));
+        }
+
+        float Float(float min, float max) {
+            return min + (max - min) * (next() / 4294967296.0f);
+        }
+
+        uint64_t state;
+};
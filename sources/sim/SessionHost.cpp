@@ -0,0 +1,137 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SessionHost.h"
+
+void HostedSession::step(float dt) {
+    if (finished)
+        return;
+    frames++;
+
+    if (game.awaitingEliteChoice())
+        game.eliteChoice(botRandom.Int(0, 1) == 1);
+
+    game.advance(dt);
+    untilNextMove -= dt;
+    if (game.isOver()) {
+        finished = true;
+        return;
+    }
+    if (untilNextMove > 0)
+        return;
+
+    candidates.clear();
+    game.board().SwapsCreatingCombination(candidates);
+    if (candidates.empty()) {
+        // settled boards always have a move, so this is a bug in the rules
+        finished = true;
+        return;
+    }
+    const BoardSwap& s = candidates[botRandom.Int(0, candidates.size() - 1)];
+    game.swap(s.i1, s.j1, s.i2, s.j2);
+
+    // animations are instant here, but the player would have to wait for them
+    untilNextMove = thinkTime + game.lastResolutionDuration;
+}
+
+size_t HostedSession::memoryUsage() const {
+    return sizeof(*this) - sizeof(game) + game.memoryUsage() + candidates.capacity() * sizeof(BoardSwap);
+}
+
+SessionHost::SessionHost(unsigned threadCount) : generation(0), busyWorkers(0), quit(false), batchDt(0), batchFrames(0), nextSession(0) {
+    // calling thread works too
+    for (unsigned i=1; i<threadCount; i++)
+        workers.push_back(std::thread(&SessionHost::work, this));
+}
+
+SessionHost::~SessionHost() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    wakeUp.notify_all();
+    for (unsigned i=0; i<workers.size(); i++)
+        workers[i].join();
+    for (unsigned i=0; i<sessions.size(); i++)
+        delete sessions[i];
+}
+
+unsigned SessionHost::addSession(GameMode mode, Difficulty difficulty, uint32_t seed, float thinkTime) {
+    HostedSession* s = new HostedSession();
+    s->botRandom.seed(~seed);
+    s->thinkTime = thinkTime;
+    s->untilNextMove = thinkTime;
+    s->finished = false;
+    s->frames = 0;
+    s->game.start(mode, difficulty, seed);
+    sessions.push_back(s);
+    return sessions.size() - 1;
+}
+
+bool SessionHost::allFinished() const {
+    for (unsigned i=0; i<sessions.size(); i++) {
+        if (!sessions[i]->finished)
+            return false;
+    }
+    return true;
+}
+
+void SessionHost::runBatch() {
+    for (unsigned i = nextSession++; i < sessions.size(); i = nextSession++) {
+        for (unsigned f=0; f<batchFrames && !sessions[i]->finished; f++)
+            sessions[i]->step(batchDt);
+    }
+}
+
+void SessionHost::work() {
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this, seen] () { return quit || generation != seen; });
+            if (quit)
+                return;
+            seen = generation;
+        }
+        runBatch();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers--;
+        }
+        batchDone.notify_one();
+    }
+}
+
+void SessionHost::step(float dt, unsigned frames) {
+    batchDt = dt;
+    batchFrames = frames;
+    nextSession = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        busyWorkers = workers.size();
+        generation++;
+    }
+    wakeUp.notify_all();
+
+    runBatch();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    batchDone.wait(lock, [this] () { return busyWorkers == 0; });
+}
@@ -0,0 +1,89 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "sim/HeadlessGame.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* One simulated game and the bot playing it */
+struct HostedSession {
+    HeadlessGame game;
+    // bot choices, independent from the game generator
+    SeededRandom botRandom;
+    // time the bot takes to find its next move
+    float thinkTime;
+    float untilNextMove;
+    bool finished;
+    // frames simulated before the game ended
+    unsigned frames;
+    std::vector<BoardSwap> candidates;
+
+    void step(float dt);
+    size_t memoryUsage() const;
+};
+
+/* Runs many independent sessions in one process. Sessions share nothing: each
+ * step() hands them out to a fixed pool of worker threads.
+ * Sessions are HeadlessGame, not HeriswapGame: HeriswapGridSystem, the mode
+ * managers and SuccessManager are in this tree, but they are process-wide
+ * singletons (theHeriswapGridSystem...) built on the engine's EntityManager and
+ * component systems, so only one rendering game can exist per process. */
+class SessionHost {
+    public:
+        SessionHost(unsigned threadCount);
+        ~SessionHost();
+
+        unsigned addSession(GameMode mode, Difficulty difficulty, uint32_t seed, float thinkTime = 1.f);
+
+        /* Advance every unfinished session by 'frames' steps of dt, in parallel.
+         * Sessions don't interact, so several frames are run per dispatch to keep
+         * synchronization cost low. Returns when all are done */
+        void step(float dt, unsigned frames = 1);
+
+        bool allFinished() const;
+        unsigned sessionCount() const { return sessions.size(); }
+        const HostedSession& session(unsigned i) const { return *sessions[i]; }
+
+        unsigned threads() const { return workers.size() + 1; }
+
+    private:
+        void work();
+        void runBatch();
+
+        std::vector<HostedSession*> sessions;
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable wakeUp, batchDone;
+        unsigned generation;
+        unsigned busyWorkers;
+        bool quit;
+
+        float batchDt;
+        unsigned batchFrames;
+        std::atomic<unsigned> nextSession;
+};
@@ -0,0 +1,152 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SessionLog.h"
+
+#include <fstream>
+#include <sstream>
+
+#define SESSION_LOG_VERSION 1
+
+SessionLog::SessionLog() : valid(false), seed(0), mode(Normal), difficulty(DifficultyEasy),
+    startLevel(1), tailElapsed(0), clock(0) {
+    claimed.points = 0;
+    claimed.time = 0;
+    claimed.level = 1;
+}
+
+void SessionLog::begin(uint32_t s, GameMode m, Difficulty d) {
+    valid = true;
+    seed = s;
+    mode = m;
+    difficulty = d;
+    startLevel = 1;
+    events.clear();
+    tailElapsed = 0;
+    clock = 0;
+}
+
+void SessionLog::recordSwap(int i1, int j1, int i2, int j2) {
+    SessionEvent e;
+    e.type = SessionEvent::Swap;
+    e.elapsed = clock;
+    e.i1 = i1; e.j1 = j1;
+    e.i2 = i2; e.j2 = j2;
+    events.push_back(e);
+    clock = 0;
+}
+
+void SessionLog::recordDifficultyChange() {
+    SessionEvent e;
+    e.type = SessionEvent::ChangeDifficulty;
+    e.elapsed = clock;
+    e.i1 = e.j1 = e.i2 = e.j2 = -1;
+    events.push_back(e);
+    clock = 0;
+}
+
+void SessionLog::claim(unsigned int points, float time, int level) {
+    tailElapsed = clock;
+    claimed.points = points;
+    claimed.time = time;
+    claimed.level = level;
+}
+
+std::string SessionLog::serialize() const {
+    std::stringstream ss;
+    ss.precision(9);
+    ss << "heriswap-session " << SESSION_LOG_VERSION << '\n';
+    ss << "seed " << seed << '\n';
+    ss << "mode " << (int)mode << '\n';
+    ss << "difficulty " << (int)difficulty << '\n';
+    ss << "start_level " << startLevel << '\n';
+    for (unsigned i=0; i<events.size(); i++) {
+        const SessionEvent& e = events[i];
+        if (e.type == SessionEvent::Swap)
+            ss << "swap " << e.elapsed << ' ' << e.i1 << ' ' << e.j1 << ' ' << e.i2 << ' ' << e.j2 << '\n';
+        else
+            ss << "change_difficulty " << e.elapsed << '\n';
+    }
+    ss << "end " << tailElapsed << '\n';
+    ss << "claim " << claimed.points << ' ' << claimed.time << ' ' << claimed.level << '\n';
+    return ss.str();
+}
+
+bool SessionLog::deserialize(const std::string& in) {
+    std::istringstream ss(in);
+    std::string key;
+    int version = 0;
+
+    if (!(ss >> key >> version) || key != "heriswap-session" || version != SESSION_LOG_VERSION)
+        return false;
+
+    begin(0, Normal, DifficultyEasy);
+    bool claimFound = false;
+    while (ss >> key) {
+        if (key == "seed") {
+            ss >> seed;
+        } else if (key == "mode") {
+            int m; ss >> m; mode = (GameMode)m;
+        } else if (key == "difficulty") {
+            int d; ss >> d; difficulty = (Difficulty)d;
+        } else if (key == "start_level") {
+            ss >> startLevel;
+        } else if (key == "swap") {
+            SessionEvent e;
+            e.type = SessionEvent::Swap;
+            ss >> e.elapsed >> e.i1 >> e.j1 >> e.i2 >> e.j2;
+            events.push_back(e);
+        } else if (key == "change_difficulty") {
+            SessionEvent e;
+            e.type = SessionEvent::ChangeDifficulty;
+            ss >> e.elapsed;
+            e.i1 = e.j1 = e.i2 = e.j2 = -1;
+            events.push_back(e);
+        } else if (key == "end") {
+            ss >> tailElapsed;
+        } else if (key == "claim") {
+            ss >> claimed.points >> claimed.time >> claimed.level;
+            claimFound = true;
+        } else {
+            return false;
+        }
+        if (ss.fail())
+            return false;
+    }
+    valid = claimFound;
+    return valid;
+}
+
+bool SessionLog::save(const std::string& path) const {
+    std::ofstream out(path.c_str());
+    if (!out)
+        return false;
+    out << serialize();
+    return out.good();
+}
+
+bool SessionLog::load(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in)
+        return false;
+    std::stringstream content;
+    content << in.rdbuf();
+    return deserialize(content.str());
+}
@@ -0,0 +1,80 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "modes/GameMode.h"
+#include "sim/Board.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+struct SessionEvent {
+    enum Type {
+        Swap,
+        ChangeDifficulty
+    } type;
+    // mode clock time elapsed since the previous event
+    float elapsed;
+    int i1, j1, i2, j2;
+};
+
+/* Everything needed to replay a game: its seed and what the player did.
+ * The game fills it while playing, the verifier replays it headless. */
+class SessionLog {
+    public:
+        SessionLog();
+
+        void begin(uint32_t seed, GameMode mode, Difficulty difficulty);
+        // to be called each frame the mode clock runs
+        void advance(float dt) { clock += dt; }
+        void recordSwap(int i1, int j1, int i2, int j2);
+        void recordDifficultyChange();
+        // close the session with the score the player claims
+        void claim(unsigned int points, float time, int level);
+        // restored games can't be replayed (seed state is not saved)
+        void invalidate() { valid = false; }
+
+        std::string serialize() const;
+        bool deserialize(const std::string& in);
+
+        bool save(const std::string& path) const;
+        bool load(const std::string& path);
+
+        bool valid;
+        uint32_t seed;
+        GameMode mode;
+        Difficulty difficulty;
+        int startLevel;
+        std::vector<SessionEvent> events;
+        // clock elapsed after the last event, until the claim
+        float tailElapsed;
+
+        struct {
+            unsigned int points;
+            float time;
+            int level;
+        } claimed;
+
+    private:
+        float clock;
+};
@@ -23,20 +23,23 @@
 
 #include "Scenes.h"
 
+#include "AssetRegistry.h"
 #include "Game_Private.h"
 #include "CombinationMark.h"
 #include "HeriswapGame.h"
 
+#include "systems/CellTweenSystem.h"
 #include "systems/TwitchSystem.h"
 #include "systems/HeriswapGridSystem.h"
 
 #include "modes/GameModeManager.h"
 
-#include "systems/ADSRSystem.h"
 #include "systems/RenderingSystem.h"
 #include "systems/SoundSystem.h"
 #include "systems/TransformationSystem.h"
 
+#include "base/TimeUtil.h"
+
 #include <vector>
 
 struct DeleteScene : public StateHandler<Scene::Enum> {
@@ -47,6 +50,10 @@ struct DeleteScene : public StateHandler<Scene::Enum> {
     std::vector<Combinais> removing;
     std::vector<GameModeManager::BranchLeaf> littleLeavesDeleted;
 
+    // cells to remove, resolved once when entering the scene
+    std::vector<Entity> deleted;
+    std::vector<Entity> byPos;
+
     DeleteScene(HeriswapGame* game) : StateHandler<Scene::Enum>("delete_scene") {
         this->game = game;
     }
@@ -64,26 +71,42 @@ struct DeleteScene : public StateHandler<Scene::Enum> {
     void onEnter(Scene::Enum from) override {
         if (from == Scene::Pause)
             return;
-        ADSR(deleteAnimation)->attackTiming = game->datas->timing.deletion;
+        const float duration = game->datas->timing.deletion;
 
         littleLeavesDeleted.clear();
+        deleted.clear();
         removing = theHeriswapGridSystem.LookForCombination(true,true);
         if (!removing.empty()) {
             game->datas->successMgr->sDoubleInOne(removing);
             game->datas->successMgr->sBimBamBoum(removing.size());
+            theHeriswapGridSystem.MapPositions(byPos);
+            const int gridSize = theHeriswapGridSystem.GridSize;
             for ( std::vector<Combinais>::reverse_iterator it = removing.rbegin(); it != removing.rend(); ++it ) {
+                const glm::vec2 size = HeriswapGame::CellSize(gridSize, it->type) * HeriswapGame::CellContentScale();
                 for ( std::vector<glm::vec2>::reverse_iterator itV = (it->points).rbegin(); itV != (it->points).rend(); ++itV ) {
-                    Entity e = theHeriswapGridSystem.GetOnPos(itV->x,itV->y);
+                    Entity e = byPos[(int)itV->x + (int)itV->y * gridSize];
+                    if (!e)
+                        continue;
                     TwitchComponent* tc = TWITCH(e);
                     if (tc->speed == 0) {
                         CombinationMark::markCellInCombination(e);
                     }
+                    theCellTweenSystem.add(CellTweenSystem::Deletion, e, CellTweenSystem::Size,
+                        size, glm::vec2(0.f), duration, 0, CellTweenSystem::Quadratic);
+                    deleted.push_back(e);
                 }
+                const unsigned alreadyDeleted = littleLeavesDeleted.size();
                 game->datas->mode2Manager[game->datas->mode]->WillScore(it->points.size(), it->type, littleLeavesDeleted);
+                for (unsigned int i=alreadyDeleted; i<littleLeavesDeleted.size(); i++) {
+                    const glm::vec2 littleLeavesSize = HeriswapGame::CellSize(8, littleLeavesDeleted[i].type) * HeriswapGame::CellContentScale();
+                    theCellTweenSystem.add(CellTweenSystem::Deletion, littleLeavesDeleted[i].e, CellTweenSystem::Size,
+                        littleLeavesSize, glm::vec2(0.f), duration, 0, CellTweenSystem::Quadratic);
+                }
 
                 game->datas->successMgr->s6InARow(it->points.size());
             }
-            SOUND(deleteAnimation)->sound = theSoundSystem.loadSoundFile("audio/son_monte.ogg");
+            SOUND(deleteAnimation)->sound = AssetRegistry::deleteSound;
+            game->datas->swapLatency.deletionStarted(TimeUtil::GetTime(), theHeriswapGridSystem.sizeToDifficulty());
         }
     }
 
@@ -91,40 +114,21 @@ struct DeleteScene : public StateHandler<Scene::Enum> {
     ///--------------------- UPDATE SECTION ---------------------------------------//
     ///----------------------------------------------------------------------------//
     Scene::Enum update(float) override {
-        ADSRComponent* transitionSuppr = ADSR(deleteAnimation);
-        if (!removing.empty()) {
-            transitionSuppr->active = true;
-            for ( std::vector<Combinais>::reverse_iterator it = removing.rbegin(); it != removing.rend(); ++it ) {
-                const glm::vec2 cellSize = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, it->type) * HeriswapGame::CellContentScale() * (1 - transitionSuppr->value);
-                if (transitionSuppr->value == transitionSuppr->sustainValue) {
-                    game->datas->mode2Manager[game->datas->mode]->ScoreCalc(it->points.size(), it->type);
-                }
-                for ( std::vector<glm::vec2>::reverse_iterator itV = (it->points).rbegin(); itV != (it->points).rend(); ++itV ) {
-                    Entity e = theHeriswapGridSystem.GetOnPos(itV->x,itV->y);
-                    //  TRANSFORM(e)->rotation = HeriswapGame::cellTypeToRotation(it->type) + (1 - transitionSuppr->value) * MathUtil::TwoPi;
-                    ADSR(e)->idleValue = cellSize.x;
-                    if (transitionSuppr->value == transitionSuppr->sustainValue) {
-                        if (e)
-                            theEntityManager.DeleteEntity(e);
-                        littleLeavesDeleted.clear();
-                    } else {
-                        glm::vec2 size = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, HERISWAPGRID(e)->type);
-                        float scale = ADSR(e)->value / size.x;
-                        TRANSFORM(e)->size = size * scale;
-                    }
-                }
-            }
-            for (unsigned int i=0; i<littleLeavesDeleted.size(); i++) {
-                const glm::vec2 littleLeavesSize = HeriswapGame::CellSize(8, littleLeavesDeleted[i].type) * HeriswapGame::CellContentScale() * (1 - transitionSuppr->value);
-                TRANSFORM(littleLeavesDeleted[i].e)->size = littleLeavesSize;
-            }
-            if (transitionSuppr->value  == transitionSuppr->sustainValue) {
-                return Scene::Fall;
-            }
-        } else {
+        if (removing.empty())
             return Scene::Spawn;
+        // leaves are shrinking
+        if (theCellTweenSystem.running(CellTweenSystem::Deletion))
+            return Scene::Delete;
+
+        for ( std::vector<Combinais>::reverse_iterator it = removing.rbegin(); it != removing.rend(); ++it ) {
+            game->datas->mode2Manager[game->datas->mode]->ScoreCalc(it->points.size(), it->type);
+        }
+        for (unsigned int i=0; i<deleted.size(); i++) {
+            theHeriswapGridSystem.ReleaseCell(deleted[i]);
         }
-        return Scene::Delete;
+        deleted.clear();
+        littleLeavesDeleted.clear();
+        return Scene::Fall;
     }
 
     ///----------------------------------------------------------------------------//
@@ -136,8 +140,8 @@ struct DeleteScene : public StateHandler<Scene::Enum> {
     void onExit(Scene::Enum to) override {
         if (to == Scene::Pause)
             return;
-        ADSR(deleteAnimation)->active = false;
         removing.clear();
+        deleted.clear();
     }
 };
 
@@ -92,13 +92,16 @@ struct ElitePopupScene : public StateHandler<Scene::Enum> {
     ///--------------------- UPDATE SECTION ---------------------------------------//
     ///----------------------------------------------------------------------------//
     Scene::Enum update(float) override {
-        if (BUTTON(eButton[0])->clicked) {
+        const bool scripted = game->datas->benchmark.active();
+        const bool bot = game->datas->soak.active();
+        if ((scripted && game->datas->benchmark.takeDifficultyChange()) || (bot && game->datas->soak.pickDifficultyChange()) || BUTTON(eButton[0])->clicked) {
+            game->datas->session.recordDifficultyChange();
             theHeriswapGridSystem.setGridFromDifficulty(theHeriswapGridSystem.nextDifficulty(theHeriswapGridSystem.sizeToDifficulty()));
             game->datas->mode2Manager[Normal]->points = 0;
             static_cast<NormalGameModeManager*>(game->datas->mode2Manager[Normal])->changeLevel(1);
             return Scene::Spawn;
         }
-        else if (BUTTON(eButton[1])->clicked)
+        else if (scripted || bot || BUTTON(eButton[1])->clicked)
             return Scene::Spawn;
         return Scene::ElitePopup;
     }
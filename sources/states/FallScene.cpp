@@ -27,30 +27,53 @@
 #include "Game_Private.h"
 #include "CombinationMark.h"
 
+#include "systems/CellTweenSystem.h"
 #include "systems/HeriswapGridSystem.h"
 
 #include <base/EntityManager.h>
 
-#include "systems/ADSRSystem.h"
 #include "systems/RenderingSystem.h"
 #include "systems/TransformationSystem.h"
 
 #include <glm/glm.hpp>
-#include <glm/gtx/compatibility.hpp>
+
+#include <algorithm>
 
 struct FallScene : public StateHandler<Scene::Enum> {
     HeriswapGame* game;
 
     // State variables
-    Entity fallAnimation;
-    std::vector<CellFall> falling;
+    float elapsed;
+
+    // falling leaves, moved by CellTweenSystem
+    struct Falling {
+        Entity e;
+        int toY;
+    };
+    std::vector<Falling> falling;
+
+    // grid snapshot, to look ahead without touching the components
+    Board board;
+    std::vector<BoardFall> falls;
+    std::vector<Entity> byPos;
+
+    // refill started during the fall: each leaf grows as soon as falling ones are
+    // out of its way (see Board::FallClearance), SpawnScene finishes the job.
+    // Entities are created along the fall, hidden at size 0, in start order, and
+    // their growth is submitted right away
+    struct Spawning {
+        Feuille f;
+        float start;
+    };
+    std::vector<Spawning> spawning;
+    unsigned created;
+    std::vector<BoardCell> cells;
 
     FallScene(HeriswapGame* game) : StateHandler<Scene::Enum>("fall_scene") {
         this->game = game;
     }
 
     void setup(AssetAPI*) override {
-        fallAnimation = theEntityManager.CreateEntityFromTemplate("fallAnimation");
     }
 
     ///----------------------------------------------------------------------------//
@@ -59,58 +82,132 @@ struct FallScene : public StateHandler<Scene::Enum> {
     void onPreEnter(Scene::Enum) override {
     }
 
-    void onEnter(Scene::Enum) override {
-        ADSR(fallAnimation)->attackTiming = game->datas->timing.fall;
+    // restored game: animations state is lost, put every leaf in place
+    void snapGrid() {
+        const int gridSize = theHeriswapGridSystem.GridSize;
+        std::vector<Entity> leaves = theHeriswapGridSystem.RetrieveLeaves();
+        for (unsigned i=0; i<leaves.size(); i++) {
+            HeriswapGridComponent* gc = HERISWAPGRID(leaves[i]);
+            if (!theHeriswapGridSystem.IsValidGridPosition(gc->i, gc->j))
+                continue;
+            TRANSFORM(leaves[i])->position = HeriswapGame::GridCoordsToPosition(gc->i, gc->j, gridSize);
+            TRANSFORM(leaves[i])->size = HeriswapGame::CellSize(gridSize, gc->type);
+        }
+    }
+
+    void onEnter(Scene::Enum from) override {
+        if (from == Scene::Pause) {
+            if (falling.empty())
+                snapGrid();
+            return;
+        }
+        const float duration = game->datas->timing.fall;
+        elapsed = 0;
 
-        falling = theHeriswapGridSystem.TileFall();
+        const int gridSize = theHeriswapGridSystem.GridSize;
+        theHeriswapGridSystem.toBoard(board);
+        theHeriswapGridSystem.MapPositions(byPos);
+        falls = board.TileFall();
 
-        // Creation de la nouvelle grille
-        for (std::vector<CellFall>::iterator it=falling.begin(); it!=falling.end(); ++it)
-        {
-            const CellFall& f = *it;
-            HERISWAPGRID(f.e)->j = f.toY;
+        falling.clear();
+        spawning.clear();
+        created = 0;
+        for (unsigned i=0; i<falls.size(); i++) {
+            const BoardFall& f = falls[i];
+            Falling cell;
+            cell.e = byPos[f.x + f.fromY * gridSize];
+            cell.toY = f.toY;
+            falling.push_back(cell);
+            theCellTweenSystem.add(CellTweenSystem::Fall, cell.e, CellTweenSystem::Position,
+                HeriswapGame::GridCoordsToPosition(f.x, f.fromY, gridSize),
+                HeriswapGame::GridCoordsToPosition(f.x, f.toY, gridSize), duration);
+
+            HeriswapGridComponent* gc = HERISWAPGRID(cell.e);
+            gc->checkedH = gc->checkedV = false;
         }
-        // Recherche de combinaison
-        std::vector<Combinais> combinaisons = theHeriswapGridSystem.LookForCombination(false,false);
-
-        // gestion des combinaisons
-        if (!combinaisons.empty())
-        {
-            for ( std::vector<Combinais>::reverse_iterator it = combinaisons.rbegin(); it != combinaisons.rend(); ++it )
-            {
-                for ( std::vector<glm::vec2>::reverse_iterator itV = (it->points).rbegin(); itV != (it->points).rend(); ++itV )
-                {
-                    Entity e = theHeriswapGridSystem.GetOnPos(itV->x, itV->y);
+        // the grid holds where leaves go, only the display is late: the state
+        // stays consistent if the game is saved during the fall
+        for (unsigned i=0; i<falling.size(); i++) {
+            HERISWAPGRID(falling[i].e)->j = falling[i].toY;
+        }
+
+        // the grid after the fall, to mark the combinations to come
+        board.ApplyFall(falls);
+        for (unsigned i=0; i<falls.size(); i++)
+            byPos[falls[i].x + falls[i].fromY * gridSize] = 0;
+        for (unsigned i=0; i<falls.size(); i++)
+            byPos[falls[i].x + falls[i].toY * gridSize] = falling[i].e;
+
+        std::vector<Combinais> combinaisons = board.LookForCombination();
+        for ( std::vector<Combinais>::reverse_iterator it = combinaisons.rbegin(); it != combinaisons.rend(); ++it ) {
+            for ( std::vector<glm::vec2>::reverse_iterator itV = (it->points).rbegin(); itV != (it->points).rend(); ++itV ) {
+                Entity e = byPos[(int)itV->x + (int)itV->y * gridSize];
+                if (e)
                     CombinationMark::markCellInCombination(e);
-                }
             }
         }
-        // On remet la grille comme avant
-         for (std::vector<CellFall>::iterator it=falling.begin(); it!=falling.end(); ++it)
-         {
-             const CellFall& f = *it;
-             HERISWAPGRID(f.e)->j = f.fromY;
-         }
+
+        // nothing to delete after the fall: the refill is known already (same
+        // draws as SpawnScene would do), so columns can start growing it
+        if (combinaisons.empty() && !falls.empty()) {
+            cells.clear();
+            board.FillTheBlank(theHeriswapGridSystem.rng, cells);
+            for (unsigned i=0; i<cells.size(); i++) {
+                Spawning s;
+                s.f.X = cells[i].x;
+                s.f.Y = cells[i].y;
+                s.f.entity = 0;
+                s.f.type = cells[i].type;
+                s.start = Board::FallClearance(falls, s.f.X, s.f.Y);
+                spawning.push_back(s);
+            }
+            std::stable_sort(spawning.begin(), spawning.end(), [] (const Spawning& a, const Spawning& b) -> bool {
+                return a.start < b.start;
+            });
+        }
+    }
+
+    /* Create the refill entities still missing: the ones about to grow, and a
+     * share of the others so that the last frame has nothing left to do */
+    void createSpawningCells(float t, float dt) {
+        if (created == spawning.size())
+            return;
+        const float fall = game->datas->timing.fall;
+        const float grow = game->datas->timing.haveToAddLeavesInGrid;
+        const float framesLeft = (dt > 0) ? (1 - t) * fall / dt : 0;
+        unsigned budget = (framesLeft > 1) ? (unsigned)glm::ceil((spawning.size() - created) / framesLeft) : spawning.size();
+        while (created < spawning.size() && (budget > 0 || spawning[created].start <= t)) {
+            Feuille& f = spawning[created].f;
+            f.entity = HeriswapGame::createCell(f, true);
+            // growth in SpawnScene pace, from when the column is clear
+            const glm::vec2 s = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, f.type);
+            const float delay = spawning[created].start * fall - elapsed;
+            const float progress = glm::clamp(-delay / grow, 0.f, 1.f);
+            theCellTweenSystem.add(CellTweenSystem::Grow, f.entity, CellTweenSystem::Size,
+                s * progress, s, grow * (1 - progress), glm::max(delay, 0.f));
+            created++;
+            if (budget > 0)
+                budget--;
+        }
     }
 
     ///----------------------------------------------------------------------------//
     ///--------------------- UPDATE SECTION ---------------------------------------//
     ///----------------------------------------------------------------------------//
-    Scene::Enum update(float) override {
-        ADSRComponent* transition = ADSR(fallAnimation);
+    Scene::Enum update(float dt) override {
         if (!falling.empty()) {
-            transition->active = true;
-            for(std::vector<CellFall>::iterator it=falling.begin(); it!=falling.end(); ++it) {
-                const CellFall& f = *it;
-                glm::vec2 targetPos = HeriswapGame::GridCoordsToPosition(f.x, f.toY,theHeriswapGridSystem.GridSize);
-                glm::vec2 originPos = HeriswapGame::GridCoordsToPosition(f.x, f.fromY,theHeriswapGridSystem.GridSize);
-                HERISWAPGRID(f.e)->checkedH = HERISWAPGRID(f.e)->checkedV = false;
-                TRANSFORM(f.e)->position = glm::lerp(originPos, targetPos, transition->value);
-                if (transition->value == 1.) {
-                    HERISWAPGRID(f.e)->j = f.toY;
+            elapsed += dt;
+            createSpawningCells(glm::min(elapsed / game->datas->timing.fall, 1.f), dt);
+            if (!theCellTweenSystem.running(CellTweenSystem::Fall)) {
+                if (!spawning.empty()) {
+                    // SpawnScene takes their growth over
+                    createSpawningCells(1, 0);
+                    std::vector<Feuille>& ahead = game->datas->spawnAhead;
+                    for (unsigned i=0; i<spawning.size(); i++)
+                        ahead.push_back(spawning[i].f);
+                    spawning.clear();
+                    return Scene::Spawn;
                 }
-            }
-            if (transition->value == 1.) {
                 std::vector<Combinais> combinaisons = theHeriswapGridSystem.LookForCombination(false, true);
                 if (combinaisons.empty()) return Scene::Spawn;
                 else return Scene::Delete;
@@ -129,9 +226,10 @@ struct FallScene : public StateHandler<Scene::Enum> {
     void onPreExit(Scene::Enum) override {
     }
 
-    void onExit(Scene::Enum) override {
+    void onExit(Scene::Enum to) override {
+        if (to == Scene::Pause)
+            return;
         falling.clear();
-        ADSR(fallAnimation)->active = false;
     }
 };
 
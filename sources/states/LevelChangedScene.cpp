@@ -31,9 +31,12 @@
 #include "modes/GameModeManager.h"
 #include "modes/NormalModeManager.h"
 
+#include "systems/DesaturationSystem.h"
 #include "systems/HeriswapGridSystem.h"
 #include "systems/TwitchSystem.h"
 
+#include "sim/Board.h"
+
 #include "base/PlacementHelper.h"
 
 #include "systems/ADSRSystem.h"
@@ -47,6 +50,7 @@
 #include <glm/glm.hpp>
 
 #include <algorithm>
+#include <future>
 #include <sstream>
 #include <vector>
 
@@ -56,6 +60,12 @@ typedef struct FeuilleOrientee {
     int sens;
 } FeuilleOrientee;
 
+// next level grid, and the generator as it will be once the grid is drawn
+struct PreparedBoard {
+    Board board;
+    SeededRandom rng;
+};
+
 struct LevelChangedScene : public StateHandler<Scene::Enum> {
     HeriswapGame* game;
 
@@ -71,6 +81,14 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
 
     float duration;
 
+    // leaves of the current level, fading out
+    std::vector<Entity> oldLeaves;
+    // next level grid, drawn on a worker thread along the animation. The same
+    // entities are then retyped, so SpawnScene only has to grow them
+    bool preparing;
+    std::future<PreparedBoard> nextBoard;
+    std::vector<Entity> byPos;
+
     enum levelState {
         Start,
         GridHided,
@@ -130,26 +148,35 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
 
         duration = 0;
 
-        // desaturate everyone except the branch, mute, pause and text elements
-        TextureRef branch = theRenderingSystem.loadTextureFile("branche");
-        TextureRef pause = theRenderingSystem.loadTextureFile("pause");
-        TextureRef sound1 = theRenderingSystem.loadTextureFile("sound_on");
-        TextureRef sound2 = theRenderingSystem.loadTextureFile("sound_off");
-        std::vector<Entity> entities = theRenderingSystem.RetrieveAllEntityWithComponent();
-        for (auto e : entities) {
-            RenderingComponent* rc = RENDERING(e);
-            if (rc->texture == branch || rc->texture == pause || rc->texture == sound1 || rc->texture == sound2) {
-                continue;
-            }
-            rc->effectRef = theRenderingSystem.effectLibrary.load("desaturate.fs");
-        }
+        // desaturate grid and decor: the branch, mute, pause and texts stay in color
+        theDesaturationSystem.desaturate(DesaturationSystem::Grid, true);
+        theDesaturationSystem.desaturate(DesaturationSystem::Decor, true);
 
-        entities = theHeriswapGridSystem.RetrieveAllEntityWithComponent();
-        for (auto e: entities) {
+        oldLeaves = theHeriswapGridSystem.RetrieveLeaves();
+        for (auto e: oldLeaves) {
             CombinationMark::markCellInCombination(e);
         }
 
         game->stopInGameMusics();
+
+        // the elite popup may change the grid size: nothing to prepare then
+        preparing = !(currentLevel == 10 && theHeriswapGridSystem.sizeToDifficulty() != DifficultyHard);
+        if (preparing) {
+            // same draws as SpawnScene would do on a new full grid
+            const int size = theHeriswapGridSystem.GridSize, types = theHeriswapGridSystem.Types;
+            const int nbmin = theHeriswapGridSystem.nbmin;
+            const SeededRandom rng = theHeriswapGridSystem.rng;
+            nextBoard = std::async(std::launch::async, [size, types, nbmin, rng] () -> PreparedBoard {
+                PreparedBoard p;
+                p.rng = rng;
+                p.board.reset(size, types);
+                p.board.nbmin = nbmin;
+                std::vector<BoardCell> cells;
+                p.board.FillTheBlank(p.rng, cells);
+                p.board.RemoveCombinations(p.rng, cells);
+                return p;
+            });
+        }
     }
 
     ///----------------------------------------------------------------------------//
@@ -163,8 +190,7 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
         }
 
         float alpha = 1 - ADSR(eGrid)->value;
-        std::vector<Entity> entities = theHeriswapGridSystem.RetrieveAllEntityWithComponent();
-        for (auto e : entities) {
+        for (auto e : oldLeaves) {
             RENDERING(e)->color.a = alpha;
             TWITCH(e)->speed = alpha * 9;
         }
@@ -206,18 +232,19 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
             RENDERING(game->datas->mode2Manager[game->datas->mode]->herisson)->effectRef = DefaultEffectRef;
             // generating the brand-new leaves
             game->datas->mode2Manager[game->datas->mode]->generateLeaves(0, theHeriswapGridSystem.Types);
-            for (auto s : game->datas->mode2Manager[game->datas->mode]->branchLeaves) {
+            game->datas->mode2Manager[game->datas->mode]->branchLeaves.forEach([] (const GameModeManager::BranchLeaf& s) -> void {
                 TRANSFORM(s.e)->size = glm::vec2(0.f);
-            }
+            });
         }
         if (levelState == BigScoreBeganToMove || levelState == BigScoreMoving) {
             levelState = BigScoreMoving;
             //if leaves created, make them grow!
-            for (auto s : game->datas->mode2Manager[game->datas->mode]->branchLeaves) {
+            const float grow = glm::min((duration-6) / 4.f, 1.f);
+            game->datas->mode2Manager[game->datas->mode]->branchLeaves.forEach([grow] (const GameModeManager::BranchLeaf& s) -> void {
                 TRANSFORM(s.e)->size =
                     HeriswapGame::CellSize(8,
-                            s.type) * HeriswapGame::CellContentScale() * glm::min((duration-6) / 4.f, 1.f);
-            }
+                            s.type) * HeriswapGame::CellContentScale() * grow;
+            });
             RENDERING(eSnowBranch)->color.a = 1-(duration-6)/(10-6);
             RENDERING(eSnowGround)->color.a = 1-(duration-6)/(10-6.f);
         }
@@ -226,10 +253,14 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
 
         //level animation ended - back to game
         if (levelState == BigScoreMoving && duration > 10) {
-            theHeriswapGridSystem.DeleteAll();
-            if (currentLevel == 10 && theHeriswapGridSystem.sizeToDifficulty() != DifficultyHard) {
+            if (!preparing) {
+                theHeriswapGridSystem.DeleteAll();
                 return Scene::ElitePopup;
             }
+            // hand the new grid over to SpawnScene
+            const PreparedBoard prepared = nextBoard.get();
+            HeriswapGame::retypeGrid(prepared.board, byPos, game->datas->spawnAhead);
+            theHeriswapGridSystem.rng = prepared.rng;
             return Scene::Spawn;
         }
 
@@ -245,6 +276,11 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
     void onExit(Scene::Enum) override {
         ADSR(eGrid)->active = false;
         feuilles.clear();
+        // left before the end (pause): the board will be drawn again when coming back
+        if (nextBoard.valid()) {
+            nextBoard.wait();
+            nextBoard = std::future<PreparedBoard>();
+        }
         LOGI("'" << __PRETTY_FUNCTION__ << "'");
         PARTICULE(eSnowEmitter)->emissionRate = 0;
         RENDERING(eSnowBranch)->show = false;
@@ -254,22 +290,18 @@ struct LevelChangedScene : public StateHandler<Scene::Enum> {
         for (unsigned int i=0; i<mc->elements.size(); i++) {
             delete mc->elements[i];
         }
-        for (unsigned int i=0; i<game->datas->mode2Manager[game->datas->mode]->branchLeaves.size(); i++) {
-            TRANSFORM(game->datas->mode2Manager[game->datas->mode]->branchLeaves[i].e)->size =
-                HeriswapGame::CellSize(8, game->datas->mode2Manager[game->datas->mode]->branchLeaves[i].type) * HeriswapGame::CellContentScale();
-        }
+        game->datas->mode2Manager[game->datas->mode]->branchLeaves.forEach([] (const GameModeManager::BranchLeaf& s) -> void {
+            TRANSFORM(s.e)->size = HeriswapGame::CellSize(8, s.type) * HeriswapGame::CellContentScale();
+        });
         mc->elements.clear();
         // hide big level
         TEXT(eBigLevel)->show = false;
         // show small level
-        TEXT(smallLevel)->text = TEXT(eBigLevel)->text;
+        game->datas->mode2Manager[game->datas->mode]->uiHelper.setLevel(currentLevel);
         TEXT(smallLevel)->color.a = 1;
         RENDERING(game->datas->mode2Manager[game->datas->mode]->herisson)->color.a = 1;
 
-        std::vector<Entity> ent = theRenderingSystem.RetrieveAllEntityWithComponent();
-        for (unsigned int i=0; i<ent.size(); i++) {
-            RENDERING(ent[i])->effectRef = DefaultEffectRef;
-        }
+        theDesaturationSystem.clear();
     }
 };
 
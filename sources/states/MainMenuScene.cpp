@@ -22,6 +22,7 @@
 
 #include "Scenes.h"
 
+#include "AssetRegistry.h"
 #include "HeriswapGame.h"
 #include "Game_Private.h"
 #include "DepthLayer.h"
@@ -207,8 +208,6 @@ struct MainMenuScene : public StateHandler<Scene::Enum> {
                 }
             }
 
-            // preload sound effect
-            theSoundSystem.loadSoundFile("audio/son_menu.ogg");
 
 
 
@@ -239,9 +238,7 @@ struct MainMenuScene : public StateHandler<Scene::Enum> {
         if (TRANSFORM(game->herisson)->position.x < PlacementHelper::GimpXToScreen(800)+TRANSFORM(game->herisson)->size.x) {
             TRANSFORM(game->herisson)->position.x += ANIMATION(game->herisson)->playbackSpeed/8.f * dt;
         } else {
-            std::stringstream a;
-            a << "herisson_" << Random::Int(1, 8);
-            ANIMATION(game->herisson)->name = Murmur::RuntimeHash(a.str().c_str());
+            ANIMATION(game->herisson)->name = AssetRegistry::herissonAnimation[Random::Int(1, 8) - 1];
             ANIMATION(game->herisson)->playbackSpeed = Random::Float(2.0f, 4.0f);
             TRANSFORM(game->herisson)->size = randomHerissonSize();
             TRANSFORM(game->herisson)->position = AnchorSystem::adjustPositionWithCardinal(randomHerissionStart(),
@@ -249,20 +246,28 @@ struct MainMenuScene : public StateHandler<Scene::Enum> {
         }
 
         if (!modeTitleToReset || (modeTitleToReset && !MORPHING(modeTitleToReset)->active)) {
+            if (game->datas->benchmark.wantsNewGame()) {
+                choosenGameMode = game->datas->benchmark.script.mode;
+                return Scene::ModeMenu;
+            }
+            if (game->datas->soak.wantsNewGame()) {
+                choosenGameMode = game->datas->soak.nextMode();
+                return Scene::ModeMenu;
+            }
             if (BUTTON(bStart[0])->clicked) {
                 choosenGameMode = Normal;
-                SOUND(bStart[0])->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+                SOUND(bStart[0])->sound = AssetRegistry::menuSound;
                 return Scene::ModeMenu;
             }
             if(BUTTON(bStart[1])->clicked){
                 choosenGameMode = TilesAttack;
 
-                SOUND(bStart[1])->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+                SOUND(bStart[1])->sound = AssetRegistry::menuSound;
                 return Scene::ModeMenu;
             }
             if(BUTTON(bStart[2])->clicked){
                 choosenGameMode = Go100Seconds;
-                SOUND(bStart[2])->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+                SOUND(bStart[2])->sound = AssetRegistry::menuSound;
                 return Scene::ModeMenu;
             }
             if(BUTTON(aboutSac)->clicked){
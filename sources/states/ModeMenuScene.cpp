@@ -23,6 +23,7 @@
 
 #include "Scenes.h"
 
+#include "AssetRegistry.h"
 #include "Game_Private.h"
 #include "HeriswapGame.h"
 
@@ -59,6 +60,7 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -249,22 +251,26 @@ struct ModeMenuScene : public StateHandler<Scene::Enum> {
     }
 
     void submitScore(const std::string& playerName) {
+        // bot games must not reach the scores table nor the leaderboards
+        if (game->datas->soak.active())
+            return;
         ScoreStorageProxy ssp;
         ssp.pushAnElement();
         ssp.setValue("points", ObjectSerializer<int>::object2string(game->datas->mode2Manager[game->datas->mode]->points));
         ssp.setValue("time", ObjectSerializer<float>::object2string(game->datas->mode2Manager[game->datas->mode]->time));
         ssp.setValue("name", playerName);
 
+        int level = 1;
         if (game->datas->mode==Normal) {
             NormalGameModeManager* ng = static_cast<NormalGameModeManager*>(game->datas->mode2Manager[game->datas->mode]);
-            ssp.setValue("level", ObjectSerializer<int>::object2string(ng->currentLevel()));
-        } else {
-            ssp.setValue("level", ObjectSerializer<int>::object2string(1));
+            level = ng->currentLevel();
         }
+        ssp.setValue("level", ObjectSerializer<int>::object2string(level));
         ssp.setValue("mode", ObjectSerializer<int>::object2string(game->datas->mode));
         ssp.setValue("difficulty", ObjectSerializer<int>::object2string(game->difficulty));
 
         game->gameThreadContext->storageAPI->saveEntries(&ssp);
+        submitSession(level);
 
 
 		if (game->gameThreadContext->gameCenterAPI) {
@@ -287,6 +293,26 @@ struct ModeMenuScene : public StateHandler<Scene::Enum> {
 		}
     }
 
+    // Keep a replayable record of the game, to be checked by heriswap_verify.
+    // Sessions are dropped in HERISWAP_SUBMISSION_DIR (if set) until a score server exists.
+    void submitSession(int level) {
+        SessionLog& session = game->datas->session;
+        if (!session.valid)
+            return;
+        GameModeManager* m = game->datas->mode2Manager[game->datas->mode];
+        session.claim(m->points, m->time, level);
+
+        const char* dir = getenv("HERISWAP_SUBMISSION_DIR");
+        if (dir) {
+            std::stringstream path;
+            path << dir << "/" << session.seed << ".session";
+            if (!session.save(path.str()))
+                LOGW("Unable to write session file: " << path.str());
+        }
+        // one submission per game
+        session.invalidate();
+    }
+
     bool isCurrentScoreAHighOne() {
         std::stringstream ss;
         ss << "where mode = " << game->datas->mode << " and difficulty = " << game->difficulty;
@@ -435,6 +461,39 @@ struct ModeMenuScene : public StateHandler<Scene::Enum> {
     ///--------------------- UPDATE SECTION ---------------------------------------//
     ///----------------------------------------------------------------------------//
     Scene::Enum update(float dt) override {
+        // scripted game: start it, and quit once it's over
+        BenchmarkDriver& benchmark = game->datas->benchmark;
+        if (benchmark.active()) {
+            if (benchmark.wantsNewGame()) {
+                game->difficulty = benchmark.script.difficulty;
+                benchmark.gameStarted();
+                return Scene::CountDown;
+            }
+            if (benchmark.finish(game->datas->swapLatency))
+                game->gameThreadContext->exitAPI->exitGame();
+            return Scene::ModeMenu;
+        }
+
+        // soak test: sample (the score is not stored), and start the next game
+        SoakDriver& soak = game->datas->soak;
+        if (soak.active()) {
+            if (gameOverState == GameEnded) {
+                gameOverState = NoGame;
+                soak.gameEnded(game->gameThreadContext->storageAPI);
+            }
+            if (soak.done()) {
+                if (soak.finish())
+                    game->gameThreadContext->exitAPI->exitGame();
+                return Scene::ModeMenu;
+            }
+            // the mode is picked in the main menu
+            if (game->datas->mode != soak.nextMode())
+                return Scene::MainMenu;
+            game->difficulty = soak.nextDifficulty();
+            soak.gameStarted();
+            return Scene::CountDown;
+        }
+
         switch (gameOverState) {
             case NoGame: {
                 game->modeMenuIsInNameInput = false;
@@ -515,7 +574,7 @@ struct ModeMenuScene : public StateHandler<Scene::Enum> {
         if (gameOverState != AskingPlayerName) {
             //difficulty button
             if (BUTTON(bDifficulty)->clicked) {
-                SOUND(bDifficulty)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+                SOUND(bDifficulty)->sound = AssetRegistry::menuSound;
                 game->difficulty = theHeriswapGridSystem.nextDifficulty(game->difficulty);
 
                 if (game->difficulty == DifficultyEasy) {
@@ -532,7 +591,7 @@ struct ModeMenuScene : public StateHandler<Scene::Enum> {
 
             //new game button
             else if (BUTTON(playContainer)->clicked) {
-                SOUND(playContainer)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+                SOUND(playContainer)->sound = AssetRegistry::menuSound;
 
                 std::stringstream ss;
                 ss << "where mode = " << (int)game->datas->mode << " and difficulty = " << (int)game->difficulty;
@@ -564,7 +623,7 @@ struct ModeMenuScene : public StateHandler<Scene::Enum> {
             //back button
             else if (BUTTON(back)->clicked || pleaseGoBack) {
                 pleaseGoBack = false;
-                SOUND(back)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+                SOUND(back)->sound = AssetRegistry::menuSound;
                 return Scene::MainMenu;
             }
 
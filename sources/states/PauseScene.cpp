@@ -23,6 +23,7 @@
 
 #include "Scenes.h"
 
+#include "AssetRegistry.h"
 #include "Game_Private.h"
 #include "HeriswapGame.h"
 
@@ -87,7 +88,6 @@ struct PauseScene : public StateHandler<Scene::Enum> {
     }
 
     void onEnter(Scene::Enum from) override {
-        theSoundSystem.loadSoundFile("audio/son_menu.ogg");
         TEXT(eRestart)->show = true;
         RENDERING(bRestart)->show = true;
         TEXT(eAbort)->show = true;
@@ -119,13 +119,13 @@ struct PauseScene : public StateHandler<Scene::Enum> {
     ///----------------------------------------------------------------------------//
     Scene::Enum update(float) override {
         if (SWYPEBUTTON(bAbort)->clicked) {
-            SOUND(bAbort)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+            SOUND(bAbort)->sound = AssetRegistry::menuSound;
             return Scene::MainMenu;
         } if (BUTTON(bRestart)->clicked) {
-            SOUND(bRestart)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+            SOUND(bRestart)->sound = AssetRegistry::menuSound;
             return previousState;
         } if (BUTTON(bHelp)->clicked) {
-            SOUND(bHelp)->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+            SOUND(bHelp)->sound = AssetRegistry::menuSound;
             return Scene::Help;
         }
         return Scene::Pause;
@@ -23,6 +23,7 @@
 
 #include "Scenes.h"
 
+#include "AssetRegistry.h"
 #include "Game_Private.h"
 #include "HeriswapGame.h"
 
@@ -106,17 +107,17 @@ struct RateItScene : public StateHandler<Scene::Enum> {
     Scene::Enum update(float) override {
         //want to rate
         if (BUTTON(boutonContainer[0])->clicked) {
-            SOUND(boutonContainer[0])->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+            SOUND(boutonContainer[0])->sound = AssetRegistry::menuSound;
             game->gameThreadContext->communicationAPI->rateItNow();
             return Scene::ModeMenu;
         //will rate later
         } else if(BUTTON(boutonContainer[1])->clicked){
-            SOUND(boutonContainer[1])->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+            SOUND(boutonContainer[1])->sound = AssetRegistry::menuSound;
             game->gameThreadContext->communicationAPI->rateItLater();
             return Scene::ModeMenu;
         //won't never rate
         } else if(BUTTON(boutonContainer[2])->clicked){
-            SOUND(boutonContainer[2])->sound = theSoundSystem.loadSoundFile("audio/son_menu.ogg");
+            SOUND(boutonContainer[2])->sound = AssetRegistry::menuSound;
             game->gameThreadContext->communicationAPI->rateItNever();
             return Scene::ModeMenu;
         }
@@ -26,13 +26,15 @@
 #include "Game_Private.h"
 #include "HeriswapGame.h"
 
-#include "DepthLayer.h"
 #include "CombinationMark.h"
 
 #include "modes/GameModeManager.h"
 
+#include "systems/CellTweenSystem.h"
 #include "systems/TwitchSystem.h"
 
+#include "sim/Board.h"
+
 #include "base/EntityManager.h"
 
 #include "systems/ADSRSystem.h"
@@ -40,8 +42,6 @@
 #include "systems/ScrollingSystem.h"
 #include "systems/TransformationSystem.h"
 
-#include "util/Random.h"
-
 #include <glm/glm.hpp>
 
 #include <sstream>
@@ -50,115 +50,63 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
 	HeriswapGame* game;
 
 	// State variables
-	Entity haveToAddLeavesInGrid, replaceGrid;
+	Entity replaceGrid;
 	std::vector<Feuille> newLeaves;
+	// newLeaves grow tweens are submitted
+	bool growing;
+	// grid replacement scratch, kept to allocate nothing once sized
+	Board freshBoard;
+	std::vector<BoardCell> freshCells;
+	std::vector<Entity> byPos;
+	Board nextBoard;
 
 	SpawnScene(HeriswapGame* game) : StateHandler<Scene::Enum>("spawn_scene") {
 	    this->game = game;
+	    growing = false;
 	}
 
 	void setup(AssetAPI*) override {
-		haveToAddLeavesInGrid = theEntityManager.CreateEntityFromTemplate("spawn/haveToAddLeavesInGrid");
 		replaceGrid = theEntityManager.CreateEntityFromTemplate("spawn/replaceGrid");
 	}
 
-	static int newLeavesInSpawning(std::vector<Feuille>& newLeaves, int i, int j) {
-		for (unsigned int k=0; k<newLeaves.size(); k++)
-			if (newLeaves[k].X == i && newLeaves[k].Y == j)
-				return newLeaves[k].type;
-		return -1;
-	}
-
 	static void fillTheBlank(std::vector<Feuille>& newLeaves)
 	{
-		for (int i=0; i<theHeriswapGridSystem.GridSize; i++){
-			for (int j=0; j<theHeriswapGridSystem.GridSize; j++){
-				Entity e = theHeriswapGridSystem.GetOnPos(i,j);
-				//oh ! it misses someone on (i,j)
-				if (!e){
-					//get its neighboors...
-					Entity voisins[8] = {
-						theHeriswapGridSystem.GetOnPos(i-2, j),
-						theHeriswapGridSystem.GetOnPos(i-1, j),
-						theHeriswapGridSystem.GetOnPos(i+1, j),
-						theHeriswapGridSystem.GetOnPos(i+2, j),
-						theHeriswapGridSystem.GetOnPos(i, j-2),
-						theHeriswapGridSystem.GetOnPos(i, j-1),
-						theHeriswapGridSystem.GetOnPos(i, j+1),
-						theHeriswapGridSystem.GetOnPos(i, j+2)
-					};
-
-					//and their types
-					int typeVoisins[8];
-					for (int k = 0; k < 4; k++) {
-						typeVoisins[k] = voisins[k] ? HERISWAPGRID(voisins[k])->type : newLeavesInSpawning(newLeaves, i-2+k, j);
-					} for (int k = 4; k < 8; k++)
-						typeVoisins[k] = voisins[k] ? HERISWAPGRID(voisins[k])->type : newLeavesInSpawning(newLeaves, i, j-6+k);
-
-					//get a type which doesn't create a combi with its neighboors
-					int type, ite = 0;
-					do {
-						type = Random::Int(0, theHeriswapGridSystem.Types-1);
-						ite++;
-					} while (theHeriswapGridSystem.GridPosIsInCombination(i, j, type, typeVoisins) && ite<5000);
-
-					Feuille nouvfe = {i,j,0,type};
-					newLeaves.push_back(nouvfe);
-				}
-			}
-		}
-	}
+		Board board;
+		theHeriswapGridSystem.toBoard(board);
+		//leaves still spawning are not in the grid yet
+		for (unsigned int k=0; k<newLeaves.size(); k++)
+			board.set(newLeaves[k].X, newLeaves[k].Y, newLeaves[k].type);
 
-	static Entity createCell(Feuille& f, bool assignGridPos) {
-		Entity e = theEntityManager.CreateEntityFromTemplate("spawn/cell");
-		ADD_COMPONENT(e, HeriswapGrid);
-	    ADD_COMPONENT(e, Twitch);
-
-		TRANSFORM(e)->position = HeriswapGame::GridCoordsToPosition(f.X, f.Y, theHeriswapGridSystem.GridSize);
-		TRANSFORM(e)->z = DL_Cell + Random::Float(0.f, 1.f) * 0.001f;
-		RenderingComponent* rc = RENDERING(e);
-		rc->show = true;
-
-		TRANSFORM(e)->size = glm::vec2(0.f);
-		ADSR(e)->idleValue = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, f.type).x * HeriswapGame::CellContentScale();
-		HERISWAPGRID(e)->type = f.type;
-		if (assignGridPos) {
-			HERISWAPGRID(e)->i = f.X;
-			HERISWAPGRID(e)->j = f.Y;
+		std::vector<BoardCell> cells;
+		board.FillTheBlank(theHeriswapGridSystem.rng, cells);
+		for (unsigned int k=0; k<cells.size(); k++) {
+			Feuille nouvfe = {cells[k].x, cells[k].y, 0, cells[k].type};
+			newLeaves.push_back(nouvfe);
 		}
-		rc->texture = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(f.type, &TRANSFORM(e)->rotation));
-		return e;
 	}
 
 	void removeEntitiesInCombination() {
-		std::vector<Combinais> c;
-		unsigned int ite = 0;
-		//remove direct combinations but keep combinations to do (give up at 100 try)
-		do {
-			c = theHeriswapGridSystem.LookForCombination(false,true);
-			// change type from cells in combi
-			for(unsigned int i=0; i<c.size(); i++) {
-				int j = Random::Int(0, c[i].points.size()-1);
-				Entity e = theHeriswapGridSystem.GetOnPos(c[i].points[j].x, c[i].points[j].y);
-				int type, iter = 0;
-				do {
-					type = Random::Int(0, theHeriswapGridSystem.Types-1);
-					iter++;
-				} while (theHeriswapGridSystem.GridPosIsInCombination(c[i].points[j].x, c[i].points[j].y, type, 0) && iter < 100);
-				HERISWAPGRID(e)->type = type;
-				RenderingComponent* rc = RENDERING(e);
-				rc->texture = theRenderingSystem.loadTextureFile(HeriswapGame::cellTypeToTextureNameAndRotation(type, &TRANSFORM(e)->rotation));
-			}
-			ite++;
-		} while((!c.empty() || !theHeriswapGridSystem.StillCombinations()) && ite<100);
+		Board board;
+		theHeriswapGridSystem.toBoard(board);
+		//remove direct combinations but keep combinations to do
+		std::vector<BoardCell> retyped;
+		board.RemoveCombinations(theHeriswapGridSystem.rng, retyped);
+
+		for (unsigned int k=0; k<retyped.size(); k++) {
+			Entity e = theHeriswapGridSystem.GetOnPos(retyped[k].x, retyped[k].y);
+			HeriswapGame::setCellType(e, retyped[k].type);
+		}
 	}
 
-	Scene::Enum NextState(bool recheckEveryoneInGrid) {
-		std::vector<Combinais> combinaisons = theHeriswapGridSystem.LookForCombination(false, recheckEveryoneInGrid);
+	Scene::Enum NextState() {
+		// checked on a snapshot: the components scans would walk the parked cells
+		// too, StillCombinations once per neighbour of every cell
+		theHeriswapGridSystem.toBoard(nextBoard);
+		std::vector<Combinais> combinaisons = nextBoard.LookForCombination();
 		//pas de combinaisons à supprimer, qu'est-ce qu'il faut donc faire ?
 		if (combinaisons.empty()) {
 			//si y a plus de combi, on genere une nouvelle grille (uniquement parce que y a plus de solutions)
-			if (!theHeriswapGridSystem.StillCombinations()) {
+			if (!nextBoard.StillCombinations()) {
 				//(on doit pas etre en changement de niveau / fin de jeu)
 				if (game->datas->mode == Normal &&
 					game->datas->mode2Manager[game->datas->mode]->LevelUp())
@@ -169,7 +117,7 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
                 ADSR(replaceGrid)->activationTime = 0;
                 ADSR(replaceGrid)->value = ADSR(replaceGrid)->idleValue;
 				ADSR(replaceGrid)->active = true;
-				std::vector<Entity> feuilles = theHeriswapGridSystem.RetrieveAllEntityWithComponent();
+				std::vector<Entity> feuilles = theHeriswapGridSystem.RetrieveLeaves();
 				for ( std::vector<Entity>::reverse_iterator it = feuilles.rbegin(); it != feuilles.rend(); ++it ) {
 					CombinationMark::markCellInCombination(*it);
 				}
@@ -193,8 +141,13 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
             game->datas->faderHelper.start(Fading::In, 0.5);
         }
 
-		ADSR(haveToAddLeavesInGrid)->attackTiming = game->datas->timing.haveToAddLeavesInGrid;
         ADSR(replaceGrid)->attackTiming = game->datas->timing.replaceGrid;
+		growing = false;
+
+		// leaves created by FallScene or LevelChangedScene: they are already in the grid
+		std::vector<Feuille>& ahead = game->datas->spawnAhead;
+		newLeaves.insert(newLeaves.end(), ahead.begin(), ahead.end());
+		ahead.clear();
 
 		fillTheBlank(newLeaves);
 
@@ -203,14 +156,10 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
 	     	LOGI("create '" << newLeaves.size() << "' cells");
 			for(unsigned int i=0; i<newLeaves.size(); i++) {
 	            if (newLeaves[i].entity == 0)
-				    newLeaves[i].entity = createCell(newLeaves[i], true);
+				    newLeaves[i].entity = HeriswapGame::createCell(newLeaves[i], true);
 			}
-	        ADSR(haveToAddLeavesInGrid)->active = true;
 			removeEntitiesInCombination();
-		} else {
-		    ADSR(haveToAddLeavesInGrid)->active = false;
-	    }
-	    ADSR(haveToAddLeavesInGrid)->activationTime = 0;
+		}
 
 		ADSR(replaceGrid)->activationTime = 0;
 		ADSR(replaceGrid)->active = false;
@@ -229,28 +178,38 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
 
     bool updateLeavesSpawn() {
         bool fullGridSpawn = (newLeaves.size() == (unsigned)theHeriswapGridSystem.GridSize*theHeriswapGridSystem.GridSize);
-        ADSR(haveToAddLeavesInGrid)->active = true;
-        for ( std::vector<Feuille>::reverse_iterator it = newLeaves.rbegin(); it != newLeaves.rend(); ++it ) {
-            if (it->entity == 0) {
-                it->entity = createCell(*it, fullGridSpawn);
-            } else {
+        if (!growing) {
+            const float duration = game->datas->timing.haveToAddLeavesInGrid;
+            for ( std::vector<Feuille>::reverse_iterator it = newLeaves.rbegin(); it != newLeaves.rend(); ++it ) {
+                if (it->entity == 0) {
+                    it->entity = HeriswapGame::createCell(*it, fullGridSpawn);
+                } else {
+                    // some started growing during the fall: go on from their size
+                    theCellTweenSystem.cancel(it->entity);
+                }
                 HeriswapGridComponent* gc = HERISWAPGRID(it->entity);
                 if (fullGridSpawn) {
                     gc->i = gc->j = -1;
                 }
-                TransformationComponent* tc = TRANSFORM(it->entity);
                 //leaves grow up from 0 to fixed size
-                glm::vec2 s = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, gc->type);
-                if (ADSR(haveToAddLeavesInGrid)->value == 1){
-                    tc->size = glm::vec2(s.x, s.y);
-                    gc->i = it->X;
-                    gc->j = it->Y;
-                } else {
-                    tc->size = s * ADSR(haveToAddLeavesInGrid)->value;
-                }
+                const glm::vec2 s = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, gc->type);
+                const glm::vec2 size = TRANSFORM(it->entity)->size;
+                const float progress = glm::min(size.x / s.x, 1.f);
+                theCellTweenSystem.add(CellTweenSystem::Grow, it->entity, CellTweenSystem::Size,
+                    size, s, duration * (1 - progress));
             }
+            growing = true;
+            return false;
+        }
+        if (theCellTweenSystem.running(CellTweenSystem::Grow))
+            return false;
+
+        for ( std::vector<Feuille>::reverse_iterator it = newLeaves.rbegin(); it != newLeaves.rend(); ++it ) {
+            HeriswapGridComponent* gc = HERISWAPGRID(it->entity);
+            gc->i = it->X;
+            gc->j = it->Y;
         }
-        return (ADSR(haveToAddLeavesInGrid)->value == 1);
+        return true;
     }
 
 	///----------------------------------------------------------------------------//
@@ -262,29 +221,32 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
 			//tout le monde est en place : quel sera le prochain état ?
 			if (updateLeavesSpawn()) {
 				newLeaves.clear();
-				return NextState(true);
+				growing = false;
+				return NextState();
 			}
 		//sinon si on est en train de remplacer la grille (plus de combinaisons en cours de jeu)
 		} else if (ADSR(replaceGrid)->active) {
             const float value = ADSR(replaceGrid)->value;
-	        std::vector<Entity> feuilles = theHeriswapGridSystem.RetrieveAllEntityWithComponent();
+	        std::vector<Entity> feuilles = theHeriswapGridSystem.RetrieveLeaves();
 	        //les feuilles disparaissent (taille tend vers 0)
 	        for ( std::vector<Entity>::reverse_iterator it = feuilles.rbegin(); it != feuilles.rend(); ++it ) {
 	            const glm::vec2 size = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, HERISWAPGRID(*it)->type) * HeriswapGame::CellContentScale() * (1 - ADSR(replaceGrid)->value);
                 TRANSFORM(*it)->size = size * (1 - value);
 	        }
-	        //les feuilles ont disparu, on les supprime et on remplit avec de nouvelles feuilles
+	        //les feuilles ont disparu, on leur donne les types d'une nouvelle grille
 	        if (value == ADSR(replaceGrid)->sustainValue) {
-				theHeriswapGridSystem.DeleteAll();
-	            fillTheBlank(newLeaves);
+				// drawn as if the grid was empty, then the same entities are retyped
+				freshBoard.reset(theHeriswapGridSystem.GridSize, theHeriswapGridSystem.Types);
+				freshBoard.nbmin = theHeriswapGridSystem.nbmin;
+				freshCells.clear();
+				freshBoard.FillTheBlank(theHeriswapGridSystem.rng, freshCells);
+				HeriswapGame::retypeGrid(freshBoard, byPos, newLeaves);
 	            LOGI("nouvelle grille de '" << newLeaves.size() << "' elements! ");
 	            game->datas->successMgr->gridResetted = true;
-	            ADSR(haveToAddLeavesInGrid)->activationTime = 0;
-				ADSR(haveToAddLeavesInGrid)->active = true;
 	        }
 	    //sinon on regarde dans quel état on arrive avec notre grille actuelle
 	    } else {
-			return NextState(false);
+			return NextState();
 		}
 		return Scene::Spawn;
 	}
@@ -298,9 +260,10 @@ struct SpawnScene : public StateHandler<Scene::Enum> {
 	void onExit(Scene::Enum) override {
 		LOGI("'" << __PRETTY_FUNCTION__ << "'");
 		for (Feuille& e: newLeaves) {
-			theEntityManager.DeleteEntity(e.entity);
+			theHeriswapGridSystem.ReleaseCell(e.entity);
 		}
 		newLeaves.clear();
+		growing = false;
 	}
 };
 
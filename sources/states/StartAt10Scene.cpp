@@ -106,6 +106,7 @@ struct StartAt10Scene : public StateHandler<Scene::Enum> {
             game->setupGameProp();
             game->datas->mode2Manager[Normal]->points = 0;
             static_cast<NormalGameModeManager*>(game->datas->mode2Manager[Normal])->changeLevel(10);
+            game->datas->session.startLevel = 10;
 
             return Scene::Spawn;
         }
@@ -23,19 +23,22 @@
 
 #include "Scenes.h"
 
+#include "AssetRegistry.h"
 #include "Game_Private.h"
 #include "HeriswapGame.h"
 #include "CombinationMark.h"
 
+#include "systems/CellTweenSystem.h"
+#include "systems/DesaturationSystem.h"
 #include "systems/HeriswapGridSystem.h"
 
 #include "base/EntityManager.h"
 #include "base/Log.h"
+#include "base/TimeUtil.h"
 #include "base/TouchInputManager.h"
 
 #include "systems/ADSRSystem.h"
 #include "systems/ButtonSystem.h"
-#include "systems/MorphingSystem.h"
 #include "systems/RenderingSystem.h"
 #include "systems/SoundSystem.h"
 #include "systems/TransformationSystem.h"
@@ -43,9 +46,11 @@
 #include "modes/NormalModeManager.h"
 
 #include <glm/glm.hpp>
-#include <glm/gtx/norm.hpp>
 #include <glm/gtx/compatibility.hpp>
 
+// cancelled swap: time for the leaves to go back
+static const float RollbackDuration = 0.1f;
+
 struct UserInputScene : public StateHandler<Scene::Enum> {
     HeriswapGame* game;
 
@@ -61,7 +66,15 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
     // SuccessManager* successMgr;
 
     Entity currentCell, swappedCell;
-    Entity rollback;
+
+    // evaluated when the drag begins, on a copy of the grid: does swapping
+    // currentCell with its left, right, bottom, top neighbour create a combination ?
+    Board snapshot;
+    bool swapValid[4];
+    std::vector<Entity> byPos;
+    SwipeTracker swipe;
+    // the last swap is being rolled back, its latency trace ends with the animation
+    bool rollingBack;
 
     UserInputScene(HeriswapGame* game) : StateHandler<Scene::Enum>("user_input_scene") {
         this->game = game;
@@ -71,73 +84,42 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
         swapAnimation = theEntityManager.CreateEntityFromTemplate("swap_animation");
         originI = originJ = -1;
         swapI = swapJ = 0;
-
-        rollback = theEntityManager.CreateEntityFromTemplate("rollback");
+        rollingBack = false;
     }
 
-    static bool contains(const std::vector<Combinais>& combi, const HeriswapGridComponent* g) {
-        for (unsigned int i=0; i<combi.size(); i++) {
-            for (unsigned int j=0; j<combi[i].points.size(); j++) {
-                const glm::vec2& p = combi[i].points[j];
-                if (p.x == g->i && p.y == g->j)
-                    return true;
-            }
-        }
-        return false;
-    }
-
-    static Entity cellUnderFinger(const glm::vec2& pos, bool) {
-        std::vector<Combinais> combinaisons;// = theHeriswapGridSystem.LookForCombination(false,false);
-        const float maxDist = HeriswapGame::CellSize(theHeriswapGridSystem.GridSize, 0).y;
-
-        // 4 nearest
-        Entity e = 0;
-        float nearestDist = maxDist;
-        bool nearestInCombi = 0;
-
-        std::vector<Entity> leaves = theHeriswapGridSystem.RetrieveAllEntityWithComponent();
-        for (std::vector<Entity>::iterator it=leaves.begin(); it!=leaves.end(); ++it) {
-            float sqdist = glm::distance2(pos, TRANSFORM(*it)->position);
-            if (sqdist < maxDist) {
-                bool inCombi = contains(combinaisons, HERISWAPGRID(*it));
-
-                if (sqdist < nearestDist || (inCombi && !nearestInCombi)) {
-                    nearestDist = sqdist;
-                    nearestInCombi = inCombi;
-                    e = *it;
-                }
-            }
-        }
-        return e;
+    // the grid doesn't change during this scene: leaf at each position, index i + j * GridSize
+    Entity leafOnPos(int i, int j) const {
+        const int gridSize = theHeriswapGridSystem.GridSize;
+        if (i < 0 || j < 0 || i >= gridSize || j >= gridSize)
+            return 0;
+        return byPos[i + j * gridSize];
     }
 
-    static Entity moveToCell(Entity original, const glm::vec2& move,
-#if SAC_ANDROID
-        float threshold) {
-#else
-        float) {
-#endif
-
-#if SAC_ANDROID
-        if (glm::length2(move) < threshold)
+    Entity cellUnderFinger(const glm::vec2& pos) const {
+        const int gridSize = theHeriswapGridSystem.GridSize;
+        // as far as ~1 cell from its center
+        const float tolerance = HeriswapGame::CellSize(gridSize, 0).y;
+        int i, j;
+        if (!HeriswapGame::PositionToGridCoords(pos, gridSize, tolerance, i, j))
             return 0;
-#endif
+        return leafOnPos(i, j);
+    }
 
-        int i = HERISWAPGRID(original)->i;
-        int j = HERISWAPGRID(original)->j;
+    static int neighbourIndex(Entity a, Entity b) {
+        const int di = HERISWAPGRID(b)->i - HERISWAPGRID(a)->i;
+        const int dj = HERISWAPGRID(b)->j - HERISWAPGRID(a)->j;
+        if (di)
+            return (di < 0) ? 0 : 1;
+        return (dj < 0) ? 2 : 3;
+    }
 
-        if (glm::abs(move.x) > glm::abs(move.y)) {
-            if (move.x < 0) {
-                return theHeriswapGridSystem.GetOnPos(i-1,j);
-            } else {
-                return theHeriswapGridSystem.GetOnPos(i+1,j);
-            }
-        } else {
-            if (move.y < 0) {
-                return theHeriswapGridSystem.GetOnPos(i,j-1);
-            } else {
-                return theHeriswapGridSystem.GetOnPos(i,j+1);
-            }
+    void evaluateSwaps(Entity cell) {
+        static const int offsets[4][2] = { {-1, 0}, {1, 0}, {0, -1}, {0, 1} };
+        theHeriswapGridSystem.toBoard(snapshot);
+        const int i = HERISWAPGRID(cell)->i, j = HERISWAPGRID(cell)->j;
+        for (int k=0; k<4; k++) {
+            const int i2 = i + offsets[k][0], j2 = j + offsets[k][1];
+            swapValid[k] = snapshot.get(i2, j2) != Board::Empty && snapshot.SwapCreatesCombination(i, j, i2, j2);
         }
     }
 
@@ -150,6 +132,63 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
         HERISWAPGRID(b)->j = jA;
     }
 
+    // automated games: swap cells right away, no touch nor animation involved
+    Scene::Enum automatedSwap(const BoardSwap& s) {
+        Entity a = theHeriswapGridSystem.GetOnPos(s.i1, s.j1);
+        Entity b = theHeriswapGridSystem.GetOnPos(s.i2, s.j2);
+        if (!a || !b) {
+            LOGW("Automated swap out of the grid: (" << s.i1 << "," << s.j1 << ") - (" << s.i2 << "," << s.j2 << ")");
+            return Scene::UserInput;
+        }
+
+        HERISWAPGRID(a)->checkedH = HERISWAPGRID(a)->checkedV = false;
+        HERISWAPGRID(b)->checkedH = HERISWAPGRID(b)->checkedV = false;
+        exchangeGridCoords(a, b);
+        if (theHeriswapGridSystem.LookForCombination(false, false).empty()) {
+            LOGW("Automated swap doesn't create a combination, game and script diverged");
+            exchangeGridCoords(a, b);
+            return Scene::UserInput;
+        }
+        game->datas->session.recordSwap(s.i1, s.j1, s.i2, s.j2);
+        TRANSFORM(a)->position = HeriswapGame::GridCoordsToPosition(s.i2, s.j2, theHeriswapGridSystem.GridSize);
+        TRANSFORM(b)->position = HeriswapGame::GridCoordsToPosition(s.i1, s.j1, theHeriswapGridSystem.GridSize);
+        const float now = TimeUtil::GetTime();
+        game->datas->swapLatency.automatedSwap(now);
+        game->datas->swapLatency.swapShown(now);
+        return Scene::Delete;
+    }
+
+    // scripted game: swaps as recorded
+    Scene::Enum scriptedSwap() {
+        BenchmarkDriver& benchmark = game->datas->benchmark;
+        if (benchmark.scriptEnded()) {
+            return Scene::EndGame;
+        }
+        BoardSwap s;
+        if (!benchmark.nextSwap(s)) {
+            return Scene::UserInput;
+        }
+        return automatedSwap(s);
+    }
+
+    // soak test: random valid swaps
+    Scene::Enum botSwap() {
+        SoakDriver& soak = game->datas->soak;
+        if (soak.gameTooLong()) {
+            return Scene::EndGame;
+        }
+        if (!soak.moveDue()) {
+            return Scene::UserInput;
+        }
+        Board board;
+        theHeriswapGridSystem.toBoard(board);
+        BoardSwap s;
+        if (!soak.pickSwap(board, s)) {
+            return Scene::UserInput;
+        }
+        return automatedSwap(s);
+    }
+
     ///----------------------------------------------------------------------------//
     ///--------------------- ENTER SECTION ----------------------------------------//
     ///----------------------------------------------------------------------------//
@@ -166,6 +205,9 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
         dragged = 0;
 
         currentCell = swappedCell = 0;
+        theHeriswapGridSystem.MapPositions(byPos);
+        // events from the previous scenes are outdated
+        game->datas->touchEvents.clear();
 
         game->datas->successMgr->timeUserInputloop = 0.f;
         game->datas->successMgr->sBimBamBoum(0);
@@ -175,6 +217,11 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
     ///--------------------- UPDATE SECTION ---------------------------------------//
     ///----------------------------------------------------------------------------//
     Scene::Enum update(float dt) override {
+        if (rollingBack && !theCellTweenSystem.running(CellTweenSystem::Rollback)) {
+            rollingBack = false;
+            game->datas->swapLatency.rollbackEnded(TimeUtil::GetTime(), theHeriswapGridSystem.sizeToDifficulty());
+        }
+
         //get the game progress
         const float percentDone = game->datas->mode2Manager[game->datas->mode]->GameProgressPercent();
 
@@ -195,107 +242,145 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
             }
         }
 
+        if (game->datas->benchmark.active()) {
+            return scriptedSwap();
+        }
+        if (game->datas->soak.active()) {
+            return botSwap();
+        }
+
         game->datas->successMgr->timeUserInputloop += dt;
         game->datas->successMgr->sWhatToDo(theTouchInputManager.wasTouched(0) && theTouchInputManager.isTouched(0), dt);
 
-        if (MORPHING(rollback)->active) {
+        // every touch event since last frame, in order: as the platform posted
+        // them, or else what the touch manager shows this frame
+        TouchEventQueue& touches = game->datas->touchEvents;
+        if (!touches.takePosted())
+            touches.sample(theTouchInputManager.isTouched(0), theTouchInputManager.getTouchLastPosition(0), TimeUtil::GetTime());
+
+        if (theCellTweenSystem.running(CellTweenSystem::Rollback)) {
+            touches.clear();
             return Scene::UserInput;
         }
 
+        TouchEvent event;
+        while (touches.pop(event)) {
+            const Scene::Enum next = handleTouch(event);
+            if (next != Scene::UserInput) {
+                touches.clear();
+                return next;
+            }
+            // swap cancelled: the rest of this drag is ignored
+            if (theCellTweenSystem.running(CellTweenSystem::Rollback)) {
+                touches.clear();
+                break;
+            }
+        }
+        return Scene::UserInput;
+    }
+
+    Scene::Enum handleTouch(const TouchEvent& event) {
         if (!currentCell) {
             // beginning of drag
-            if (!theTouchInputManager.wasTouched(0) &&
-                theTouchInputManager.isTouched(0)) {
-                const glm::vec2& pos = theTouchInputManager.getTouchLastPosition(0);
-                currentCell = cellUnderFinger(pos, true);
+            if (event.type == TouchEvent::Down) {
+                currentCell = cellUnderFinger(event.position);
 
                 if (currentCell) {
+                    game->datas->swapLatency.touchDown(event.time);
                     CombinationMark::markCellInCombination(currentCell);
+                    evaluateSwaps(currentCell);
+#if SAC_ANDROID
+                    const float threshold = TRANSFORM(currentCell)->size.x * 0.01f;
+#else
+                    const float threshold = 0;
+#endif
+                    swipe.begin(HeriswapGame::GridCoordsToPosition(HERISWAPGRID(currentCell)->i, HERISWAPGRID(currentCell)->j,theHeriswapGridSystem.GridSize), threshold);
                 }
             }
-        } else {
-            const glm::vec2 posA = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(currentCell)->i, HERISWAPGRID(currentCell)->j,theHeriswapGridSystem.GridSize);
-            const glm::vec2& pos = theTouchInputManager.getTouchLastPosition(0);
-            // compute move
-            glm::vec2 move = pos - posA;
-
-            if (theTouchInputManager.isTouched(0)) {
-                // swap cell on axis
-                Entity c = moveToCell(currentCell, move, TRANSFORM(currentCell)->size.x * 0.01f);
-
-                // same cell, keep going
-                if (c && (!swappedCell || swappedCell == c)) {
-                    if (!swappedCell) {
-                        CombinationMark::markCellInCombination(c);
-                    }
-                    swappedCell = c;
+            return Scene::UserInput;
+        }
 
-                    const glm::vec2 posB = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
-                    float t = glm::min(1.0f, glm::length(move));
-                    TRANSFORM(currentCell)->position = glm::lerp(posA, posB, t);
-                    TRANSFORM(swappedCell)->position = glm::lerp(posA, posB, 1 - t);
-                } else {
-                    if (swappedCell) {
-                        CombinationMark::clearCellInCombination(swappedCell);
-                        // different cell, restore pos
-                        TRANSFORM(swappedCell)->position = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
-                    }
-                    if (!c) {
-                        TRANSFORM(currentCell)->position = posA;
-                    } else {
-                        CombinationMark::markCellInCombination(c);
-                    }
-                    swappedCell = c;
+        const glm::vec2& posA = swipe.origin;
+        // compute move
+        glm::vec2 move = event.position - posA;
+
+        if (event.type != TouchEvent::Up) {
+            // swap cell on axis: the target only changes at the event where the
+            // swipe crosses into another direction
+            if (swipe.feed(event)) {
+                Entity c = 0;
+                if (swipe.direction != glm::ivec2(0)) {
+                    c = leafOnPos(HERISWAPGRID(currentCell)->i + swipe.direction.x, HERISWAPGRID(currentCell)->j + swipe.direction.y);
                 }
-            } else {
-                // release
-                CombinationMark::clearCellInCombination(currentCell);
                 if (swappedCell) {
                     CombinationMark::clearCellInCombination(swappedCell);
+                    // different cell, restore pos
+                    TRANSFORM(swappedCell)->position = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
+                }
+                if (!c) {
+                    TRANSFORM(currentCell)->position = posA;
+                } else {
+                    CombinationMark::markCellInCombination(c);
+                }
+                swappedCell = c;
+            }
+
+            if (swappedCell) {
+                const glm::vec2 posB = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
+                float t = glm::min(1.0f, glm::length(move));
+                // preview: a swap that won't be kept only goes halfway
+                if (!swapValid[neighbourIndex(currentCell, swappedCell)])
+                    t = glm::min(0.5f, t);
+                TRANSFORM(currentCell)->position = glm::lerp(posA, posB, t);
+                TRANSFORM(swappedCell)->position = glm::lerp(posA, posB, 1 - t);
+            }
+        } else {
+            // release
+            CombinationMark::clearCellInCombination(currentCell);
+            if (swappedCell) {
+                CombinationMark::clearCellInCombination(swappedCell);
+
+                if (glm::length(move) < TRANSFORM(currentCell)->size.x * 0.5) {
+                    // restore position
+                    TRANSFORM(currentCell)->position = posA;
+                    TRANSFORM(swappedCell)->position = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
+                } else {
+                    const glm::vec2 posB = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
 
-                    if (glm::length(move) < TRANSFORM(currentCell)->size.x * 0.5) {
-                        // restore position
-                        TRANSFORM(currentCell)->position = posA;
-                        TRANSFORM(swappedCell)->position = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
+                    // already evaluated when the drag began
+                    const bool valid = swapValid[neighbourIndex(currentCell, swappedCell)];
+                    SwapLatency& latency = game->datas->swapLatency;
+                    latency.released(event.time);
+                    // the swap was decided when the swipe crossed toward swappedCell
+                    latency.detected(swipe.intentTime, valid, theHeriswapGridSystem.sizeToDifficulty());
+                    if (!valid) {
+                        // cancel swap
+                        theCellTweenSystem.add(CellTweenSystem::Rollback, currentCell, CellTweenSystem::Position,
+                            TRANSFORM(currentCell)->position, posA, RollbackDuration);
+                        theCellTweenSystem.add(CellTweenSystem::Rollback, swappedCell, CellTweenSystem::Position,
+                            TRANSFORM(swappedCell)->position, posB, RollbackDuration);
+                        SOUND(swapAnimation)->sound = AssetRegistry::rollbackSound;
+                        rollingBack = true;
                     } else {
-                        const glm::vec2 posB = HeriswapGame::GridCoordsToPosition(HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j,theHeriswapGridSystem.GridSize);
-
-                        int typeA = HERISWAPGRID(currentCell)->type;
-                        int typeB = HERISWAPGRID(swappedCell)->type;
-                        // exchange types
-                        HERISWAPGRID(currentCell)->type = typeB;
-                        HERISWAPGRID(swappedCell)->type = typeA;
-                        // check combi
-                        std::vector<Combinais> combinaisons = theHeriswapGridSystem.LookForCombination(false,false);
-                        // restore types
-                        HERISWAPGRID(currentCell)->type = typeA;
-                        HERISWAPGRID(swappedCell)->type = typeB;
-
-                        if (combinaisons.empty()) {
-                            // cancel swap
-                            theMorphingSystem.clear(MORPHING(rollback));
-                            MORPHING(rollback)->elements.push_back(new TypedMorphElement<glm::vec2>(
-                                &TRANSFORM(currentCell)->position, TRANSFORM(currentCell)->position, posA));
-                            MORPHING(rollback)->elements.push_back(new TypedMorphElement<glm::vec2>(
-                                &TRANSFORM(swappedCell)->position, TRANSFORM(swappedCell)->position, posB));
-                            MORPHING(rollback)->active = true;
-                            SOUND(swapAnimation)->sound = theSoundSystem.loadSoundFile("audio/son_descend.ogg");
-                        } else {
-                            HERISWAPGRID(currentCell)->checkedH  = false;
-                            HERISWAPGRID(currentCell)->checkedV = false;
-                            HERISWAPGRID(swappedCell)->checkedH = false;
-                            HERISWAPGRID(swappedCell)->checkedV = false;
-                            exchangeGridCoords(currentCell, swappedCell);
-                            TRANSFORM(currentCell)->position = posB;
-                            TRANSFORM(swappedCell)->position = posA;
-                            return Scene::Delete;
-                        }
+                        HERISWAPGRID(currentCell)->checkedH  = false;
+                        HERISWAPGRID(currentCell)->checkedV = false;
+                        HERISWAPGRID(swappedCell)->checkedH = false;
+                        HERISWAPGRID(swappedCell)->checkedV = false;
+                        game->datas->session.recordSwap(
+                            HERISWAPGRID(currentCell)->i, HERISWAPGRID(currentCell)->j,
+                            HERISWAPGRID(swappedCell)->i, HERISWAPGRID(swappedCell)->j);
+                        exchangeGridCoords(currentCell, swappedCell);
+                        TRANSFORM(currentCell)->position = posB;
+                        TRANSFORM(swappedCell)->position = posA;
+                        // exchanged right away, drawn this frame
+                        latency.swapShown(TimeUtil::GetTime());
+                        return Scene::Delete;
                     }
-                } else {
-                    TRANSFORM(currentCell)->position = posA;
                 }
-                swappedCell = currentCell = 0;
+            } else {
+                TRANSFORM(currentCell)->position = posA;
             }
+            swappedCell = currentCell = 0;
         }
         return Scene::UserInput;
     }
@@ -350,6 +435,11 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
 
     void onExit(Scene::Enum nextState) override {
         inCombinationCells.clear();
+        // paused or game over before the leaves got back: the time isn't the rollback's
+        if (rollingBack) {
+            rollingBack = false;
+            game->datas->swapLatency.drop();
+        }
 
         //quand c'est plus au joueur de jouer, on supprime les marquages sur les feuilles
         game->toggleShowCombi(false);
@@ -357,11 +447,7 @@ struct UserInputScene : public StateHandler<Scene::Enum> {
             std::vector<Entity>& leavesInHelpCombination =
                 static_cast<NormalGameModeManager*> (game->datas->mode2Manager[Normal])->leavesInHelpCombination;
             if (!leavesInHelpCombination.empty()) {
-                std::vector<Entity> leaves = theHeriswapGridSystem.RetrieveAllEntityWithComponent();
-                for ( std::vector<Entity>::reverse_iterator it = leaves.rbegin(); it != leaves.rend(); ++it) {
-                    RENDERING(*it)->effectRef = DefaultEffectRef;
-                }
-
+                theDesaturationSystem.desaturate(DesaturationSystem::Grid, false);
                 leavesInHelpCombination.clear();
             }
         }
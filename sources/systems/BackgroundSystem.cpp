@@ -23,9 +23,11 @@
 
 #include "DepthLayer.h"
 
+#include "base/EntityManager.h"
 #include "base/PlacementHelper.h"
 #include "base/Interval.h"
 
+#include "systems/DesaturationSystem.h"
 #include "systems/RenderingSystem.h"
 #include "systems/TransformationSystem.h"
 
@@ -64,50 +66,84 @@ BackgroundSystem::BackgroundSystem() : ComponentSystemImpl<BackgroundComponent>(
     textures[2].push_back("bas_4"); width2HeightRatio[2].push_back(79.0f / 205.0f);
 }
 
-void BackgroundSystem::initCloud(Entity e, int group) {
+void BackgroundSystem::createClouds(int perGroup) {
+    for (int group=0; group<3; group++) {
+        textureRefs[group].clear();
+        for (unsigned i=0; i<textures[group].size(); i++)
+            textureRefs[group].push_back(theRenderingSystem.loadTextureFile(textures[group][i].c_str()));
+
+        for (int i=0; i<perGroup; i++) {
+            Cloud cloud;
+            cloud.e = theEntityManager.CreateEntityFromTemplate("general/cloud");
+            cloud.tc = TRANSFORM(cloud.e);
+            cloud.rc = RENDERING(cloud.e);
+            cloud.bc = BACKGROUND(cloud.e);
+            cloud.bc->group = group;
+            cloud.rc->show = true;
+            theDesaturationSystem.tag(cloud.e, DesaturationSystem::Decor);
+            initCloud(cloud, group);
+            clouds[group].push_back(cloud);
+        }
+    }
+}
+
+void BackgroundSystem::RecoverClouds() {
+    for (int group=0; group<3; group++)
+        clouds[group].clear();
+    FOR_EACH_ENTITY_COMPONENT(Background, e, bc)
+        Cloud cloud;
+        cloud.e = e;
+        cloud.tc = TRANSFORM(e);
+        cloud.rc = RENDERING(e);
+        cloud.bc = bc;
+        clouds[bc->group].push_back(cloud);
+        theDesaturationSystem.tag(e, DesaturationSystem::Decor);
+    END_FOR_EACH()
+}
+
+void BackgroundSystem::initCloud(Cloud& cloud, int group) {
     float ratio = 1.67f;
 
     LOGF_IF(group < 0 || group > 2, "Invalid group value: " << group);
     float width = cloudSize[group].random();
-    TRANSFORM(e)->position.x = cloudStartX.random();
-    TRANSFORM(e)->position.y = cloudY[group].random();
-    TRANSFORM(e)->z = DL_Cloud;
-
-    int idx = Random::Int(0, textures[group].size()-1);
-    RENDERING(e)->texture = theRenderingSystem.loadTextureFile(textures[group][idx].c_str());
-    RENDERING(e)->color = Color(1,1,1, Random::Float(0.6f, 0.9f));
-    RENDERING(e)->show = true;
-    TRANSFORM(e)->size = glm::vec2(width, width / ratio);
-    BACKGROUND(e)->visible = false;
-    BACKGROUND(e)->speed = cloudSpeed[group].random();
+    cloud.tc->position.x = cloudStartX.random();
+    cloud.tc->position.y = cloudY[group].random();
+    cloud.tc->z = DL_Cloud;
+
+    int idx = Random::Int(0, textureRefs[group].size()-1);
+    cloud.rc->texture = textureRefs[group][idx];
+    cloud.rc->color = Color(1,1,1, Random::Float(0.6f, 0.9f));
+    cloud.tc->size = glm::vec2(width, width / ratio);
+    cloud.bc->speed = cloudSpeed[group].random();
 }
 
 void BackgroundSystem::DoUpdate(float dt) {
-    FOR_EACH_ENTITY_COMPONENT(Background, e, bc)
-        if(bc->enable) {
-            TransformationComponent* tc = TRANSFORM(e);
-            tc->position.x += (skySpeed + bc->speed) * dt;
-            if (!theRenderingSystem.isVisible(e)) {
-                if (bc->visible)
-                    initCloud(e, bc->group);
-            } else {
-                bc->visible = true;
-            }
+    // clouds only go left: once past the left border they won't be seen again
+    const float leftBorder = -PlacementHelper::ScreenSize.x * 0.5f;
+    for (int group=0; group<3; group++) {
+        for (unsigned i=0; i<clouds[group].size(); i++) {
+            Cloud& cloud = clouds[group][i];
+            if (!cloud.bc->enable)
+                continue;
+            cloud.tc->position.x += (skySpeed + cloud.bc->speed) * dt;
+            if (cloud.tc->position.x + cloud.tc->size.x * 0.5f < leftBorder)
+                initCloud(cloud, group);
         }
-    END_FOR_EACH()
+    }
 }
 
 void BackgroundSystem::showAll() {
-    FOR_EACH_ENTITY_COMPONENT(Background, e, bc)
-        RENDERING(e)->show =
-            bc->visible =
-            bc->enable = true;
-    END_FOR_EACH()
+    for (int group=0; group<3; group++) {
+        for (unsigned i=0; i<clouds[group].size(); i++) {
+            clouds[group][i].rc->show =
+                clouds[group][i].bc->enable = true;
+        }
+    }
 }
 
 void BackgroundSystem::hideAll() {
-    FOR_EACH_ENTITY_COMPONENT(Background, e, bc)
-        RENDERING(e)->show =
-            bc->visible = false;
-    END_FOR_EACH()
+    for (int group=0; group<3; group++) {
+        for (unsigned i=0; i<clouds[group].size(); i++)
+            clouds[group][i].rc->show = false;
+    }
 }
@@ -21,14 +21,16 @@
 #pragma once
 
 #include "systems/System.h"
+#include "systems/RenderingSystem.h"
 #include "base/Interval.h"
 
+struct TransformationComponent;
+
 struct BackgroundComponent {
-    BackgroundComponent() : speed(0), group(0), enable(false), visible(false) {}
+    BackgroundComponent() : speed(0), group(0), enable(false) {}
     float speed;
     int group;
     bool enable;
-    bool visible;
 };
 
 #define theBackgroundSystem BackgroundSystem::GetInstance()
@@ -40,8 +42,24 @@ public:
     void hideAll();
     void showAll();
 
-    void initCloud(Entity e, int group);
+    /* Clouds are created once, 'perGroup' for each depth: they come back on the
+     * right when they leave the screen */
+    void createClouds(int perGroup);
+    // entities were deserialized: the clouds components may be new ones
+    void RecoverClouds();
 private:
+    struct Cloud {
+        Entity e;
+        // resolved once, clouds are never deleted
+        TransformationComponent* tc;
+        RenderingComponent* rc;
+        BackgroundComponent* bc;
+    };
+    void initCloud(Cloud& cloud, int group);
+
+    std::vector<Cloud> clouds[3];
+    std::vector<TextureRef> textureRefs[3];
+
     float skySpeed;
     //clouds
     Interval<float> cloudStartX;
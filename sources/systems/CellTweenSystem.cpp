@@ -0,0 +1,145 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "CellTweenSystem.h"
+
+#include "base/Log.h"
+
+#include "systems/TransformationSystem.h"
+
+CellTweenSystem* CellTweenSystem::instance = 0;
+
+void CellTweenSystem::CreateInstance() {
+    LOGF_IF(instance, "CellTweenSystem created twice");
+    instance = new CellTweenSystem();
+}
+
+void CellTweenSystem::DestroyInstance() {
+    delete instance;
+    instance = 0;
+}
+
+CellTweenSystem& CellTweenSystem::GetInstance() {
+    return *instance;
+}
+
+CellTweenSystem::CellTweenSystem() : clock(0) {
+    for (int g=0; g<GroupCount; g++)
+        counts[g] = 0;
+}
+
+void CellTweenSystem::add(Group group, Entity e, Property property, const glm::vec2& from, const glm::vec2& to,
+    float duration, float delay, Curve curve) {
+    TransformationComponent* tc = TRANSFORM(e);
+    glm::vec2* target = (property == Position) ? &tc->position : &tc->size;
+    *target = from;
+
+    entities.push_back(e);
+    targets.push_back(target);
+    fromX.push_back(from.x);
+    fromY.push_back(from.y);
+    deltaX.push_back(to.x - from.x);
+    deltaY.push_back(to.y - from.y);
+    startTime.push_back(clock + delay);
+    // a null duration ends on the next update
+    invDuration.push_back(duration > 0 ? 1 / duration : 1e9f);
+    curves.push_back(curve);
+    groups.push_back(group);
+    counts[group]++;
+}
+
+void CellTweenSystem::removeAt(unsigned k) {
+    const unsigned last = entities.size() - 1;
+    counts[groups[k]]--;
+    entities[k] = entities[last]; entities.pop_back();
+    targets[k] = targets[last]; targets.pop_back();
+    fromX[k] = fromX[last]; fromX.pop_back();
+    fromY[k] = fromY[last]; fromY.pop_back();
+    deltaX[k] = deltaX[last]; deltaX.pop_back();
+    deltaY[k] = deltaY[last]; deltaY.pop_back();
+    startTime[k] = startTime[last]; startTime.pop_back();
+    invDuration[k] = invDuration[last]; invDuration.pop_back();
+    curves[k] = curves[last]; curves.pop_back();
+    groups[k] = groups[last]; groups.pop_back();
+}
+
+void CellTweenSystem::clear(Group group) {
+    for (unsigned k=entities.size(); k-- > 0;) {
+        if (groups[k] == group)
+            removeAt(k);
+    }
+}
+
+void CellTweenSystem::clear() {
+    for (int g=0; g<GroupCount; g++)
+        counts[g] = 0;
+    entities.clear();
+    targets.clear();
+    fromX.clear();
+    fromY.clear();
+    deltaX.clear();
+    deltaY.clear();
+    startTime.clear();
+    invDuration.clear();
+    curves.clear();
+    groups.clear();
+}
+
+void CellTweenSystem::cancel(Entity e) {
+    for (unsigned k=entities.size(); k-- > 0;) {
+        if (entities[k] == e)
+            removeAt(k);
+    }
+}
+
+void CellTweenSystem::Update(float dt) {
+    if (entities.empty())
+        return;
+    clock += dt;
+
+    const unsigned count = entities.size();
+    progress.resize(count);
+    float* t = &progress[0];
+
+    // straight loops over floats, no branch but the clamp
+    const float* start = &startTime[0];
+    const float* inv = &invDuration[0];
+    for (unsigned k=0; k<count; k++) {
+        t[k] = glm::clamp((clock - start[k]) * inv[k], 0.f, 1.f);
+    }
+    const unsigned char* curve = &curves[0];
+    for (unsigned k=0; k<count; k++) {
+        t[k] = (curve[k] == Quadratic) ? t[k] * t[k] : t[k];
+    }
+    const float* fx = &fromX[0], *fy = &fromY[0], *dx = &deltaX[0], *dy = &deltaY[0];
+    for (unsigned k=0; k<count; k++) {
+        glm::vec2* target = targets[k];
+        target->x = fx[k] + dx[k] * t[k];
+        target->y = fy[k] + dy[k] * t[k];
+    }
+
+    // finished tweens leave (their last value is written)
+    for (unsigned k=count; k-- > 0;) {
+        if (t[k] >= 1)
+            removeAt(k);
+    }
+}
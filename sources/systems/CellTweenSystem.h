@@ -0,0 +1,82 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "base/Entity.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/* Grid cells animations (deletion, fall, growth, rollback): scenes submit tweens of
+ * a cell position or size, then wait for their group to be done. Tweens are kept
+ * in parallel arrays, the target field address is resolved once when submitted
+ * (like MorphingSystem does), so a frame costs one pass over plain floats and no
+ * component lookup.
+ *
+ * The clock only runs outside of the Pause scene (see HeriswapGame::tick). */
+class CellTweenSystem {
+    public:
+        enum Property { Position, Size };
+        // same as the ADSR attack modes of the animation entities
+        enum Curve { Linear, Quadratic };
+        enum Group { Deletion, Fall, Grow, Rollback, GroupCount };
+
+        static void CreateInstance();
+        static void DestroyInstance();
+        static CellTweenSystem& GetInstance();
+
+        /* Animate 'e' property from 'from' to 'to' in 'duration' seconds, starting in
+         * 'delay' seconds. The property is set to 'from' right away */
+        void add(Group group, Entity e, Property property, const glm::vec2& from, const glm::vec2& to,
+            float duration, float delay = 0, Curve curve = Linear);
+
+        // the group still has running tweens
+        bool running(Group group) const { return counts[group] > 0; }
+        // stop tweens where they are
+        void clear(Group group);
+        void clear();
+        void cancel(Entity e);
+
+        void Update(float dt);
+
+    private:
+        CellTweenSystem();
+        void removeAt(unsigned k);
+
+        static CellTweenSystem* instance;
+
+        float clock;
+        unsigned counts[GroupCount];
+
+        // one entry per tween
+        std::vector<Entity> entities;
+        std::vector<glm::vec2*> targets;
+        std::vector<float> fromX, fromY, deltaX, deltaY;
+        std::vector<float> startTime, invDuration;
+        std::vector<unsigned char> curves, groups;
+        // per frame scratch: progress of each tween
+        std::vector<float> progress;
+};
+
+#define theCellTweenSystem CellTweenSystem::GetInstance()
@@ -0,0 +1,114 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "DesaturationSystem.h"
+
+#include "AssetRegistry.h"
+
+#include "base/Log.h"
+
+#include "systems/AnchorSystem.h"
+#include "systems/RenderingSystem.h"
+
+#include <algorithm>
+
+DesaturationSystem* DesaturationSystem::instance = 0;
+
+void DesaturationSystem::CreateInstance() {
+    LOGF_IF(instance, "DesaturationSystem created twice");
+    instance = new DesaturationSystem();
+}
+
+void DesaturationSystem::DestroyInstance() {
+    delete instance;
+    instance = 0;
+}
+
+DesaturationSystem& DesaturationSystem::GetInstance() {
+    return *instance;
+}
+
+DesaturationSystem::DesaturationSystem() {
+    for (int g=0; g<GroupCount; g++)
+        enabled[g] = false;
+}
+
+void DesaturationSystem::tag(Entity e, Group group) {
+    // restored games tag again what they recover
+    if (std::find(members[group].begin(), members[group].end(), e) == members[group].end())
+        members[group].push_back(e);
+    RENDERING(e)->effectRef = enabled[group] ? AssetRegistry::desaturate : DefaultEffectRef;
+}
+
+void DesaturationSystem::tagScrolling(Entity scrolling, Group group) {
+    scrollings[group].push_back(scrolling);
+}
+
+void DesaturationSystem::untag(Entity e) {
+    for (int g=0; g<GroupCount; g++) {
+        std::vector<Entity>& m = members[g];
+        std::vector<Entity>::iterator it = std::find(m.begin(), m.end(), e);
+        if (it != m.end()) {
+            *it = m.back();
+            m.pop_back();
+        }
+    }
+}
+
+void DesaturationSystem::resolveScrolling(Group group) {
+    std::vector<Entity>& parents = scrollings[group];
+    std::vector<Entity> sprites = theRenderingSystem.RetrieveAllEntityWithComponent();
+    for (unsigned i=0; i<sprites.size(); i++) {
+        AnchorComponent* ac = theAnchorSystem.Get(sprites[i], false);
+        if (ac && std::find(parents.begin(), parents.end(), ac->parent) != parents.end()
+            && std::find(members[group].begin(), members[group].end(), sprites[i]) == members[group].end())
+            members[group].push_back(sprites[i]);
+    }
+    parents.clear();
+}
+
+void DesaturationSystem::desaturate(Group group, bool e) {
+    if (enabled[group] == e)
+        return;
+    if (e && !scrollings[group].empty())
+        resolveScrolling(group);
+    enabled[group] = e;
+
+    const EffectRef effect = e ? AssetRegistry::desaturate : DefaultEffectRef;
+    std::vector<Entity>& m = members[group];
+    for (unsigned i=0; i<m.size(); ) {
+        RenderingComponent* rc = theRenderingSystem.Get(m[i], false);
+        if (!rc) {
+            // deleted without untag()
+            m[i] = m.back();
+            m.pop_back();
+            continue;
+        }
+        rc->effectRef = effect;
+        i++;
+    }
+}
+
+void DesaturationSystem::clear() {
+    for (int g=0; g<GroupCount; g++)
+        desaturate((Group)g, false);
+}
@@ -0,0 +1,70 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "base/Entity.h"
+
+#include <vector>
+
+/* Desaturation by group of entities: the grid cells and the decor (herisson,
+ * branch leaves, clouds, scrolling layers) are tagged once when created, then a
+ * whole group switches effect in one call. A switch only writes the group members,
+ * and nothing at all if the group is already in the requested state; no walk over
+ * every rendering entity, no texture comparison.
+ * The engine has no render layer to flip, so members keep their own effectRef.
+ *
+ * Members are kept as entities and their RenderingComponent looked up at each
+ * switch: entities deleted without untag() are dropped then. */
+class DesaturationSystem {
+    public:
+        enum Group { Grid, Decor, GroupCount };
+
+        static void CreateInstance();
+        static void DestroyInstance();
+        static DesaturationSystem& GetInstance();
+
+        // 'e' gets the current effect of the group; tagging twice is harmless
+        void tag(Entity e, Group group);
+        /* The sprites of a ScrollingComponent belong to ScrollingSystem and may not
+         * exist yet: they are looked up the first time the group is desaturated */
+        void tagScrolling(Entity scrolling, Group group);
+        // before deleting a tagged entity, so that the group doesn't keep it
+        void untag(Entity e);
+
+        void desaturate(Group group, bool enabled);
+        bool desaturated(Group group) const { return enabled[group]; }
+        // every group back to normal
+        void clear();
+
+    private:
+        DesaturationSystem();
+        void resolveScrolling(Group group);
+
+        static DesaturationSystem* instance;
+
+        bool enabled[GroupCount];
+        std::vector<Entity> members[GroupCount];
+        std::vector<Entity> scrollings[GroupCount];
+};
+
+#define theDesaturationSystem DesaturationSystem::GetInstance()
@@ -26,6 +26,9 @@
 #include "systems/TransformationSystem.h"
 #include "systems/RenderingSystem.h"
 #include "systems/ADSRSystem.h"
+#include "systems/TwitchSystem.h"
+#include "systems/CellTweenSystem.h"
+#include "systems/DesaturationSystem.h"
 
 #include "util/Serializer.h"
 #include "util/Random.h"
@@ -34,6 +37,7 @@ INSTANCE_IMPL(HeriswapGridSystem);
 HeriswapGridSystem::HeriswapGridSystem() : ComponentSystemImpl<HeriswapGridComponent>(HASH("HeriswapGrid", 0xb859c88c)) {
     GridSize = Types = 8;
     nbmin = 3;
+    cellPoolHits = cellPoolMisses = 0;
     HeriswapGridComponent a;
     componentSerializer.add(new Property<int>(HASH("i", 0x87ea58bf), OFFSET(i, a)));
     componentSerializer.add(new Property<int>(HASH("j", 0xfe3dcbb), OFFSET(j, a)));
@@ -41,45 +45,28 @@ HeriswapGridSystem::HeriswapGridSystem() : ComponentSystemImpl<HeriswapGridCompo
 }
 
 Difficulty HeriswapGridSystem::sizeToDifficulty() {
-    if (GridSize == 5)
-        return DifficultyEasy;
-    else if (GridSize == 6)
-        return DifficultyMedium;
-    else
-        return DifficultyHard;
+    return Board::sizeToDifficulty(GridSize);
 }
 
 int HeriswapGridSystem::difficultyToSize(Difficulty diff) {
-    if (diff == DifficultyEasy)
-        return 5;
-    else if (diff == DifficultyMedium)
-        return 6;
-    else
-        return 8;
+    return Board::difficultyToSize(diff);
 }
 
 void HeriswapGridSystem::setGridFromDifficulty(Difficulty diff) {
-    if (diff == DifficultyEasy)
-        GridSize = Types = 5;
-    else if (diff == DifficultyMedium)
-        GridSize = Types = 6;
-    else
-        GridSize = Types = 8;
+    GridSize = Types = Board::difficultyToSize(diff);
 }
 
 Difficulty HeriswapGridSystem::nextDifficulty(Difficulty diff) {
-    switch (diff) {
-        case DifficultyEasy :
-            return DifficultyMedium;
-        case DifficultyMedium :
-            return DifficultyHard;
-        case DifficultyHard :
-            return DifficultyEasy;
-        default:
-            break;
-    }
-    //should never happen
-    return DifficultyEasy;
+    return Board::nextDifficulty(diff);
+}
+
+void HeriswapGridSystem::toBoard(Board& board) {
+    board.reset(GridSize, Types);
+    board.nbmin = nbmin;
+    forEachECDo([&board] (Entity, HeriswapGridComponent* gc) -> void {
+        if (board.isValid(gc->i, gc->j))
+            board.set(gc->i, gc->j, gc->type);
+    });
 }
 
 
@@ -98,16 +85,78 @@ void HeriswapGridSystem::print() {
 }
 
 void HeriswapGridSystem::ShowAll(bool activate) {
-    forEachEntityDo([activate] (Entity e) -> void {
-        RENDERING(e)->show = activate;
+    forEachECDo([activate] (Entity e, HeriswapGridComponent* gc) -> void {
+        if (gc->type >= 0)
+            RENDERING(e)->show = activate;
     });
 }
 
 void HeriswapGridSystem::DeleteAll() {
-    std::vector<Entity> all = this->RetrieveAllEntityWithComponent();
+    std::vector<Entity> all = RetrieveLeaves();
     for (unsigned int i=0; i<all.size(); i++) {
-        theEntityManager.DeleteEntity(all[i]);
+        ReleaseCell(all[i]);
+    }
+}
+
+std::vector<Entity> HeriswapGridSystem::RetrieveLeaves() {
+    std::vector<Entity> leaves;
+    forEachECDo([&leaves] (Entity e, HeriswapGridComponent* gc) -> void {
+        if (gc->type >= 0)
+            leaves.push_back(e);
+    });
+    return leaves;
+}
+
+static Entity buildCell() {
+    Entity e = theEntityManager.CreateEntityFromTemplate("spawn/cell");
+    ADD_COMPONENT(e, HeriswapGrid);
+    ADD_COMPONENT(e, Twitch);
+    theDesaturationSystem.tag(e, DesaturationSystem::Grid);
+    RENDERING(e)->show = false;
+    TRANSFORM(e)->size = glm::vec2(0.f);
+    return e;
+}
+
+Entity HeriswapGridSystem::AcquireCell() {
+    if (parkedCells.empty()) {
+        cellPoolMisses++;
+        return buildCell();
     }
+    cellPoolHits++;
+    Entity e = parkedCells.back();
+    parkedCells.pop_back();
+    return e;
+}
+
+void HeriswapGridSystem::ReleaseCell(Entity e) {
+    theCellTweenSystem.cancel(e);
+    if (parkedCells.size() + 1 > (unsigned)(GridSize * GridSize * 2)) {
+        theDesaturationSystem.untag(e);
+        theEntityManager.DeleteEntity(e);
+        return;
+    }
+    *HERISWAPGRID(e) = HeriswapGridComponent();
+    *TWITCH(e) = TwitchComponent();
+    *ADSR(e) = ADSRComponent();
+    RENDERING(e)->show = false;
+    TRANSFORM(e)->size = glm::vec2(0.f);
+    parkedCells.push_back(e);
+}
+
+void HeriswapGridSystem::ReserveCells() {
+    int missing = GridSize * GridSize * 2 - (int)RetrieveLeaves().size() - (int)parkedCells.size();
+    for (; missing > 0; missing--) {
+        parkedCells.push_back(buildCell());
+    }
+}
+
+void HeriswapGridSystem::RecoverParkedCells() {
+    parkedCells.clear();
+    forEachECDo([this] (Entity e, HeriswapGridComponent* gc) -> void {
+        theDesaturationSystem.tag(e, DesaturationSystem::Grid);
+        if (gc->type < 0)
+            parkedCells.push_back(e);
+    });
 }
 
 Entity HeriswapGridSystem::GetOnPos(int i, int j) {
@@ -120,6 +169,15 @@ Entity HeriswapGridSystem::GetOnPos(int i, int j) {
     return a;
 }
 
+void HeriswapGridSystem::MapPositions(std::vector<Entity>& byPos) {
+    byPos.assign(GridSize * GridSize, 0);
+    const int size = GridSize;
+    forEachECDo([&byPos, size] (Entity e, HeriswapGridComponent* bc ) -> void {
+        if (bc->i >= 0 && bc->j >= 0 && bc->i < size && bc->j < size)
+            byPos[bc->i + bc->j * size] = e;
+    });
+}
+
 void HeriswapGridSystem::ResetTest() {
     forEachECDo([] (Entity, HeriswapGridComponent* bc ) -> void {
         bc->checkedH = false;
@@ -592,11 +650,9 @@ bool HeriswapGridSystem::GridPosIsInCombination(int i, int j, int type, int* voi
 std::vector<Entity> HeriswapGridSystem::ShowOneCombination() {
     LOGW("Show one 1 combi");
     std::vector<Entity> highLightedCombi;
-    //desaturate everything
-    std::vector<Entity> leaves = RetrieveAllEntityWithComponent();
-    LOGW("Desaturate '"<< leaves.size() << "' leaves");
-    for (unsigned int i = 0; i < leaves.size(); i++)
-        RENDERING(leaves[i])->effectRef = theRenderingSystem.effectLibrary.load("desaturate.fs");
+    //desaturate everything (a previous hint may still be shown)
+    theDesaturationSystem.desaturate(DesaturationSystem::Grid, false);
+    theDesaturationSystem.desaturate(DesaturationSystem::Grid, true);
 
     //then resature one combi
     std::vector < std::vector<Entity> > c = GetSwapCombinations();
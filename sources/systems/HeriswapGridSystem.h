@@ -26,13 +26,8 @@
 #include <glm/glm.hpp>
 #include <systems/System.h>
 
-//medium is after hard because it would have ruined ppl's score using the game before adding the medium difficulty on android
-enum Difficulty {
-	SelectAllDifficulty = -1,
-	DifficultyEasy = 0,
-	DifficultyMedium = 2,
-	DifficultyHard = 1
-};
+#include "sim/Board.h"
+#include "sim/SeededRandom.h"
 
 struct Feuille {
 	int X, Y;
@@ -40,11 +35,6 @@ struct Feuille {
 	int type;
 };
 
-struct Combinais {
-	std::vector<glm::vec2> points;
-	int type;
-};
-
 struct CellFall {
 	CellFall(Entity _e, int _x=0, int fY=0, int tY=0) : e(_e), x(_x), fromY(fY), toY(tY) {}
 	Entity e;
@@ -62,6 +52,7 @@ struct HeriswapGridComponent {
 	}
 	int i;
 	int j;
+	// -1: cell parked in the pool, not a leaf
 	int type;
 	bool checkedV;
 	bool checkedH;
@@ -80,6 +71,10 @@ Entity GetOnPos(int i, int j);
 /* Return the finale list of actual combinations (no switch needed)*/
 std::vector<Combinais> LookForCombination(bool markAsChecked, bool recheckEveryone);
 
+/* Fill 'byPos' with the entity at each (i,j), index i + j * GridSize (0 if empty).
+ * One pass on the components, to replace several GetOnPos calls */
+void MapPositions(std::vector<Entity>& byPos);
+
 /* Set Back all entity at "not checked"*/
 void ResetTest();
 
@@ -132,9 +127,21 @@ bool IsValidGridPosition(int i, int j) {
 /* Is leaf in position i,j in a combination (real grid or in voisinsType configuration) ? */
 bool GridPosIsInCombination(int i, int j, int type, int* voisinsType);
 
-/* Clean the Grid from entities */
+/* Give every leaf back to the cells pool */
 void DeleteAll();
 
+/* Leaves (in the grid or about to enter it), without the parked cells */
+std::vector<Entity> RetrieveLeaves();
+
+/* Cells pool: cells are built once from their template, with all their components,
+ * and parked (hidden, type -1) instead of being deleted */
+Entity AcquireCell();
+void ReleaseCell(Entity e);
+/* Build cells until GridSize * GridSize * 2 exist (leaves and parked ones) */
+void ReserveCells();
+/* Restored game: parked cells were saved with the other entities */
+void RecoverParkedCells();
+
 /*Highlight a combination*/
 std::vector<Entity> ShowOneCombination();
 
@@ -148,6 +155,15 @@ void setGridFromDifficulty(Difficulty diff);
 
 Difficulty nextDifficulty(Difficulty diff);
 
+/* Copy the leaves types into 'board' (cells without leaf stay empty) */
+void toBoard(Board& board);
+
 int GridSize, Types;
 int nbmin;
+
+/* Used for every draw that changes the game outcome, seeded for each game */
+SeededRandom rng;
+
+std::vector<Entity> parkedCells;
+unsigned int cellPoolHits, cellPoolMisses;
 };
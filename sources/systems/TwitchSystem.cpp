@@ -22,37 +22,35 @@
 #include "TwitchSystem.h"
 
 #include <base/EntityManager.h>
-#include <glm/glm.hpp>
-#include <glm/gtc/random.hpp>
 
 #include "systems/TransformationSystem.h"
 
 INSTANCE_IMPL(TwitchSystem);
 
-TwitchSystem::TwitchSystem() : ComponentSystemImpl<TwitchComponent>(HASH("twitch_", 0x7359fcd3)) {
+TwitchSystem::TwitchSystem() : ComponentSystemImpl<TwitchComponent>(HASH("twitch_", 0x7359fcd3)), random(0x7317C4) {
 }
 
 void TwitchSystem::DoUpdate(float dt) {
+    // gather: most leaves are still, only moving ones are looked up
+    batch.clear();
+    moving.clear();
+    rotations.clear();
     FOR_EACH_ENTITY_COMPONENT(Twitch, a, tc)
-        TransformationComponent* trc = TRANSFORM(a);
-
         if (tc->maxAngle == tc->minAngle || tc->speed == 0)
             continue;
-
-        float target = (tc->target == TwitchComponent::MIN) ?
-            (tc->minAngle + tc->currentVariance) : (tc->maxAngle + tc->currentVariance);
-        if (tc->speed * dt > glm::abs(target - trc->rotation)) {
-            trc->rotation = target;
-
-            if (tc->target == TwitchComponent::MIN)
-                tc->target = TwitchComponent::MAX;
-            else
-                tc->target = TwitchComponent::MIN;
-            tc->currentVariance = glm::linearRand(-tc->variance, tc->variance);
-        } else {
-            float sign = target - trc->rotation;
-            trc->rotation = trc->rotation + sign * tc->speed * dt;
-        }
+        float* rotation = &TRANSFORM(a)->rotation;
+        batch.add(*rotation, tc->minAngle, tc->maxAngle, tc->variance, tc->speed,
+            tc->target == TwitchComponent::MAX, tc->currentVariance);
+        moving.push_back(tc);
+        rotations.push_back(rotation);
     END_FOR_EACH()
-}
 
+    batch.update(dt, random);
+
+    // write back
+    for (unsigned k=0; k<moving.size(); k++) {
+        *rotations[k] = batch.rotation[k];
+        moving[k]->target = batch.side[k] ? TwitchComponent::MAX : TwitchComponent::MIN;
+        moving[k]->currentVariance = batch.currentVariance[k];
+    }
+}
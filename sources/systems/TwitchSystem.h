@@ -23,6 +23,10 @@
 
 #include "systems/System.h"
 
+#include "util/TwitchBatch.h"
+
+#include <vector>
+
 struct TwitchComponent {
     TwitchComponent() : minAngle(0), maxAngle(0), variance(0), speed(0), target(MIN), currentVariance(0) {}
     float minAngle, maxAngle;
@@ -38,5 +42,13 @@ struct TwitchComponent {
 #define TWITCH(e) theTwitchSystem.Get(e)
 
 UPDATABLE_SYSTEM(Twitch)
+
+private:
+    // moving components of this frame, and their state side by side
+    TwitchBatch batch;
+    std::vector<TwitchComponent*> moving;
+    std::vector<float*> rotations;
+    // cosmetic: not the game generator
+    SeededRandom random;
 };
 
@@ -0,0 +1,91 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BenchmarkDriver.h"
+
+#include "sim/Board.h"
+
+#include "base/Log.h"
+
+#include <cstdlib>
+#include <fstream>
+
+BenchmarkDriver::BenchmarkDriver() : enabled(false), started(false), finished(false), nextEvent(0), clock(0) {
+}
+
+bool BenchmarkDriver::load() {
+    const char* path = getenv("HERISWAP_SCRIPT");
+    if (!path)
+        return false;
+
+    if (!script.load(path)) {
+        LOGE("Invalid script file: '" << path << "'");
+        return false;
+    }
+    if (script.startLevel != 1) {
+        LOGE("Scripts starting at level " << script.startLevel << " aren't supported");
+        return false;
+    }
+    LOGI("Playing script '" << path << "': " << script.events.size() << " events");
+    enabled = true;
+    return true;
+}
+
+bool BenchmarkDriver::nextSwap(BoardSwap& out) {
+    if (nextEvent >= script.events.size())
+        return false;
+    const SessionEvent& e = script.events[nextEvent];
+    if (e.type != SessionEvent::Swap || clock < e.elapsed)
+        return false;
+
+    out.i1 = e.i1; out.j1 = e.j1;
+    out.i2 = e.i2; out.j2 = e.j2;
+    nextEvent++;
+    clock = 0;
+    return true;
+}
+
+bool BenchmarkDriver::takeDifficultyChange() {
+    if (nextEvent >= script.events.size() || script.events[nextEvent].type != SessionEvent::ChangeDifficulty)
+        return false;
+    nextEvent++;
+    clock = 0;
+    return true;
+}
+
+bool BenchmarkDriver::scriptEnded() const {
+    return nextEvent >= script.events.size() && clock >= script.tailElapsed;
+}
+
+bool BenchmarkDriver::finish(const SwapLatency& latency) {
+    if (finished)
+        return false;
+    finished = true;
+
+    const std::string report = "{\"frames\": " + frames.toJSON() + ", \"swap_latency\": " + latency.toJSON() + "}\n";
+    const char* path = getenv("HERISWAP_FRAME_STATS");
+    if (path) {
+        std::ofstream out(path);
+        out << report;
+    } else {
+        LOGI("Frame stats:\n" << report);
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "sim/SessionLog.h"
+#include "util/SceneFrameStats.h"
+#include "util/SwapLatency.h"
+
+struct BoardSwap;
+
+/* Plays a recorded session (see SessionLog) in the real game, without any touch:
+ * menus are skipped, swaps are done at their recorded clock time, and the game
+ * thread frame durations are reported per scene once the game is over, along
+ * with the swaps latency.
+ *
+ * Enabled by the HERISWAP_SCRIPT environment variable (session file path); the
+ * report goes to HERISWAP_FRAME_STATS (or the log if unset). */
+class BenchmarkDriver {
+    public:
+        BenchmarkDriver();
+
+        bool load();
+        bool active() const { return enabled; }
+
+        // the scripted game has not been started yet
+        bool wantsNewGame() const { return enabled && !started; }
+        void gameStarted() { started = true; }
+
+        // to be called each frame with the mode clock progression
+        void advance(float dt) { clock += dt; }
+
+        /* Next swap, once its recorded time is reached */
+        bool nextSwap(BoardSwap& out);
+        /* Elite popup answer */
+        bool takeDifficultyChange();
+        /* Every event was played and the final clock time is reached */
+        bool scriptEnded() const;
+
+        /* Write the frame and swap latency report. Returns false if it was already done */
+        bool finish(const SwapLatency& latency);
+
+        SessionLog script;
+        SceneFrameStats frames;
+
+    private:
+        bool enabled, started, finished;
+        unsigned nextEvent;
+        float clock;
+};
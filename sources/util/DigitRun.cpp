@@ -0,0 +1,171 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "DigitRun.h"
+
+#include "base/Log.h"
+
+#include "api/AssetAPI.h"
+
+#include "systems/AnchorSystem.h"
+#include "systems/TextSystem.h"
+#include "systems/TransformationSystem.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// glyphs in table order: digits, then separators
+static const char glyphs[] = "0123456789:. s";
+// no glyph for the space in the fonts: blank of half the char height
+static const float SpaceWidth = 0.5f;
+
+std::list<DigitRun::Font> DigitRun::fonts;
+
+static int glyphIndex(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    const char* p = strchr(glyphs + 10, c);
+    return (p && *p) ? (p - glyphs) : -2;
+}
+
+DigitRun::DigitRun() : assetAPI(0), text(0), current(0), visible(false) {
+}
+
+void DigitRun::init(AssetAPI* api, Entity e, const char* name) {
+    assetAPI = api;
+    text = e;
+    fontName = name;
+    current = &font(assetAPI, fontName, TEXT(text)->charHeight);
+    TEXT(text)->show = false;
+}
+
+void DigitRun::destroy() {
+    for (unsigned i=0; i<sprites.size(); i++)
+        theEntityManager.DeleteEntity(sprites[i]);
+    sprites.clear();
+    chars.clear();
+}
+
+const DigitRun::Font& DigitRun::font(AssetAPI* assetAPI, const std::string& name, float charHeight) {
+    for (std::list<Font>::const_iterator it = fonts.begin(); it != fonts.end(); ++it) {
+        if (it->name == name && it->charHeight == charHeight)
+            return *it;
+    }
+
+    Font f;
+    f.name = name;
+    f.charHeight = charHeight;
+    for (int i=0; i<GlyphCount; i++) {
+        f.texture[i] = InvalidTextureRef;
+        f.width[i] = charHeight * SpaceWidth;
+    }
+    // "#" comments, then one "hex code=width,height" line per char
+    FileBuffer file = assetAPI->loadAsset(name + ".font");
+    LOGF_IF(file.data == 0, "Unable to load font '" << name << "'");
+    std::stringstream in(std::string((const char*)file.data, file.size));
+    delete[] file.data;
+    std::string line;
+    while (std::getline(in, line)) {
+        unsigned int code;
+        int w, h;
+        if (line.empty() || line[0] == '#' || sscanf(line.c_str(), "%x=%d,%d", &code, &w, &h) != 3 || h <= 0)
+            continue;
+        const int i = (code < 128) ? glyphIndex((char)code) : -2;
+        if (i < 0)
+            continue;
+        char texture[32];
+        snprintf(texture, 32, "%x_%s", code, name.c_str());
+        f.texture[i] = theRenderingSystem.loadTextureFile(texture);
+        f.width[i] = charHeight * w / (float)h;
+    }
+    fonts.push_back(f);
+    return fonts.back();
+}
+
+void DigitRun::setText(const char* s) {
+    chars.clear();
+    int digits = 0;
+    for (const char* c = s; *c; c++) {
+        const int i = glyphIndex(*c);
+        if (i == -2)
+            continue;
+        chars.push_back(i);
+        digits += (i < 10);
+    }
+    // group thousands, as TextSystem does for IsANumberBit
+    if ((TEXT(text)->flags & TextComponent::IsANumberBit) && digits == (int)chars.size()) {
+        for (int k = digits - 3; k > 0; k -= 3)
+            chars.insert(chars.begin() + k, -1);
+    }
+    layout();
+}
+
+void DigitRun::show(bool v) {
+    visible = v;
+    TEXT(text)->show = false;
+    for (unsigned i=0; i<sprites.size(); i++)
+        RENDERING(sprites[i])->show = visible && i < chars.size() && chars[i] >= 0 && current->texture[chars[i]] != InvalidTextureRef;
+}
+
+void DigitRun::layout() {
+    while (sprites.size() < chars.size()) {
+        Entity e = theEntityManager.CreateEntity(HASH("hud/digit", 0xf8c21d15));
+        ADD_COMPONENT(e, Transformation);
+        ADD_COMPONENT(e, Anchor);
+        ADD_COMPONENT(e, Rendering);
+        ANCHOR(e)->parent = text;
+        ANCHOR(e)->z = 0.001f;
+        sprites.push_back(e);
+    }
+
+    float width = 0;
+    for (unsigned i=0; i<chars.size(); i++)
+        width += (chars[i] >= 0) ? current->width[chars[i]] : current->charHeight * SpaceWidth;
+
+    const TextComponent* tc = TEXT(text);
+    float x = -width * tc->positioning;
+    for (unsigned i=0; i<chars.size(); i++) {
+        const float w = (chars[i] >= 0) ? current->width[chars[i]] : current->charHeight * SpaceWidth;
+        if (chars[i] >= 0) {
+            TRANSFORM(sprites[i])->size = glm::vec2(w, current->charHeight);
+            ANCHOR(sprites[i])->position = glm::vec2(x + w * 0.5f, 0);
+            RenderingComponent* rc = RENDERING(sprites[i]);
+            rc->texture = current->texture[chars[i]];
+            rc->color = tc->color;
+        }
+        x += w;
+    }
+    show(visible);
+}
+
+void DigitRun::update() {
+    const TextComponent* tc = TEXT(text);
+    if (tc->charHeight != current->charHeight) {
+        current = &font(assetAPI, fontName, tc->charHeight);
+        layout();
+        return;
+    }
+    for (unsigned i=0; i<chars.size(); i++)
+        RENDERING(sprites[i])->color = tc->color;
+}
@@ -0,0 +1,74 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "base/EntityManager.h"
+#include "systems/RenderingSystem.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+class AssetAPI;
+
+/* Numeric text drawn without TextSystem layout: texture and advance of the digits
+ * and separators (":. s") are computed once per font and char height, so a new
+ * value only indexes them to place one sprite per character.
+ * The TextComponent of the entity gives font, height, color, positioning and
+ * IsANumberBit; its own text is never shown. */
+class DigitRun {
+    public:
+        DigitRun();
+
+        void init(AssetAPI* assetAPI, Entity text, const char* fontName);
+        void destroy();
+
+        // characters out of "0123456789:. s" are skipped
+        void setText(const char* s);
+        void show(bool visible);
+        // follow TextComponent color and char height
+        void update();
+
+    private:
+        static const int GlyphCount = 14;
+        struct Font {
+            std::string name;
+            float charHeight;
+            TextureRef texture[GlyphCount];
+            float width[GlyphCount];
+        };
+        static const Font& font(AssetAPI* assetAPI, const std::string& name, float charHeight);
+        // never moved: runs keep a pointer to theirs
+        static std::list<Font> fonts;
+
+        void layout();
+
+        AssetAPI* assetAPI;
+        Entity text;
+        std::string fontName;
+        const Font* current;
+        bool visible;
+        // glyph index per character, -1 for a thousands separator
+        std::vector<int> chars;
+        std::vector<Entity> sprites;
+};
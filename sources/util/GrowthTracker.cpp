@@ -0,0 +1,111 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "GrowthTracker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+GrowthTracker::GrowthTracker(unsigned w, float t, float s) : reserved(0), warmUp(w), tolerance(t), slack(s) {
+}
+
+void GrowthTracker::reserve(unsigned samples, unsigned seriesCount) {
+    reserved = samples;
+    series.reserve(seriesCount);
+    for (unsigned i=0; i<series.size(); i++) {
+        series[i].x.reserve(samples);
+        series[i].values.reserve(samples);
+    }
+}
+
+void GrowthTracker::sample(unsigned x, const std::string& name, double value) {
+    for (unsigned i=0; i<series.size(); i++) {
+        if (series[i].name == name) {
+            series[i].x.push_back(x);
+            series[i].values.push_back(value);
+            return;
+        }
+    }
+    series.push_back(Series());
+    Series& s = series.back();
+    s.name = name;
+    s.x.reserve(reserved);
+    s.values.reserve(reserved);
+    s.x.push_back(x);
+    s.values.push_back(value);
+}
+
+bool GrowthTracker::isGrowing(const Series& s) const {
+    if (s.values.size() < warmUp + 3)
+        return false;
+    const unsigned begin = warmUp;
+    const unsigned count = s.values.size() - begin;
+    const unsigned third = count / 3;
+
+    // a bounded series comes back to its first levels at some point
+    const double firstMax = *std::max_element(s.values.begin() + begin, s.values.begin() + begin + third);
+    const double lastMin = *std::min_element(s.values.end() - third, s.values.end());
+    if (lastMin <= firstMax)
+        return false;
+
+    // least squares slope, extrapolated over the sampled range
+    double mx = 0, my = 0;
+    for (unsigned i=begin; i<s.values.size(); i++) {
+        mx += s.x[i];
+        my += s.values[i];
+    }
+    mx /= count;
+    my /= count;
+    double sxy = 0, sxx = 0;
+    for (unsigned i=begin; i<s.values.size(); i++) {
+        sxy += (s.x[i] - mx) * (s.values[i] - my);
+        sxx += (s.x[i] - mx) * (s.x[i] - mx);
+    }
+    if (sxx == 0)
+        return false;
+    const double trend = (sxy / sxx) * (s.x.back() - s.x[begin]);
+    return trend > std::abs(firstMax) * tolerance + slack;
+}
+
+std::vector<std::string> GrowthTracker::growing() const {
+    std::vector<std::string> result;
+    for (unsigned i=0; i<series.size(); i++) {
+        if (isGrowing(series[i]))
+            result.push_back(series[i].name);
+    }
+    return result;
+}
+
+std::string GrowthTracker::toJSON() const {
+    std::stringstream ss;
+    ss << "{\n  \"series\": [";
+    for (unsigned i=0; i<series.size(); i++) {
+        const Series& s = series[i];
+        ss << (i ? ",\n" : "\n") << "    {\"name\": \"" << s.name << "\", \"growing\": "
+            << (isGrowing(s) ? "true" : "false") << ", \"samples\": [";
+        for (unsigned k=0; k<s.values.size(); k++)
+            ss << (k ? ", " : "") << "[" << s.x[k] << ", " << s.values[k] << "]";
+        ss << "]}";
+    }
+    ss << "\n  ]\n}\n";
+    return ss.str();
+}
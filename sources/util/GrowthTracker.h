@@ -0,0 +1,62 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/* Named series of measures (memory, entity counts...) sampled along a long run,
+ * to tell a resource that levels off from one that keeps growing. */
+class GrowthTracker {
+    public:
+        /* Samples before 'warmUp' are ignored (caches filling, first loads).
+         * A series grows without bound if its last third stays above its first
+         * third, and the trend over the run exceeds 'tolerance' (relative to the
+         * first measures) plus 'slack' (absolute) */
+        GrowthTracker(unsigned warmUp = 1, float tolerance = 0.1f, float slack = 0);
+
+        void sample(unsigned x, const std::string& name, double value);
+
+        /* Allocate room for 'samples' measures per series right away: when the heap
+         * itself is tracked, the samples storage must not grow along the run */
+        void reserve(unsigned samples, unsigned seriesCount);
+
+        // names of the series growing without bound
+        std::vector<std::string> growing() const;
+
+        /* Every sample, and the growing series, as JSON */
+        std::string toJSON() const;
+
+    private:
+        struct Series {
+            std::string name;
+            std::vector<unsigned> x;
+            std::vector<double> values;
+        };
+        bool isGrowing(const Series& s) const;
+
+        std::vector<Series> series;
+        unsigned reserved;
+        unsigned warmUp;
+        float tolerance, slack;
+};
@@ -26,6 +26,7 @@
 #include "systems/TextSystem.h"
 #include "systems/TransformationSystem.h"
 #include "systems/GridSystem.h"
+#include "systems/HeriswapGridSystem.h"
 
 #include "base/Log.h"
 #include "base/EntityManager.h"
@@ -39,9 +40,22 @@ HeriswapGame* HeriswapDebugConsole::_game = 0;
 void HeriswapDebugConsole::init(HeriswapGame* game) {
     _game = game;
 
+    DebugConsole::RegisterMethod("Cell pool stats", callbackCellPool);
+    DebugConsole::RegisterMethod("Swap latency", callbackSwapLatency);
 }
 
 void HeriswapDebugConsole::callbackJumpAt9(void*) {
 }
 
+void HeriswapDebugConsole::callbackCellPool(void*) {
+    LOGI("Cell pool: " << theHeriswapGridSystem.cellPoolHits << " hits, "
+        << theHeriswapGridSystem.cellPoolMisses << " misses, "
+        << theHeriswapGridSystem.parkedCells.size() << " parked");
+}
+
+void HeriswapDebugConsole::callbackSwapLatency(void*) {
+    LOGI("Swap latency (mean/max):\n" << _game->datas->swapLatency.summary());
+    LOGI(_game->datas->swapLatency.toJSON());
+}
+
 #endif
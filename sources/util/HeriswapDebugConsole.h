@@ -31,6 +31,8 @@ class HeriswapDebugConsole {
     public:
         static void init(HeriswapGame* game);
         static void callbackJumpAt9(void* arg);
+        static void callbackCellPool(void* arg);
+        static void callbackSwapLatency(void* arg);
 
     private:
         //to interact with the game
@@ -0,0 +1,77 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "HudText.h"
+
+// writes 'value' at 'out' with at least 'minDigits' digits, returns the end
+static char* writeDigits(char* out, unsigned int value, int minDigits) {
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = '0' + value % 10;
+        value /= 10;
+    } while (value || n < minDigits);
+    while (n)
+        *out++ = tmp[--n];
+    return out;
+}
+
+HudText::HudText() {
+    reset();
+}
+
+void HudText::reset() {
+    shown = -1;
+    buffer[0] = '\0';
+}
+
+bool HudText::setUnsigned(unsigned int value) {
+    if (shown == value)
+        return false;
+    shown = value;
+    *writeDigits(buffer, value, 1) = '\0';
+    return true;
+}
+
+bool HudText::setTime(float seconds) {
+    const int s = (int)seconds;
+    const int minute = s / 60;
+    const int seconde = s % 60;
+    const int tenthsec = (seconds - minute * 60 - seconde) * 10;
+    const long long tenths = s * 10LL + tenthsec;
+    if (shown == tenths)
+        return false;
+    shown = tenths;
+
+    char* out = buffer;
+    if (minute) {
+        out = writeDigits(out, minute, 1);
+        *out++ = ':';
+    }
+    out = writeDigits(out, seconde, 2);
+    *out++ = '.';
+    out = writeDigits(out, tenthsec, 1);
+    *out++ = ' ';
+    *out++ = 's';
+    *out = '\0';
+    return true;
+}
@@ -0,0 +1,46 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+/* Text of a HUD value, formatted in place: no allocation, and set* tells
+ * whether the displayed string changed, so that the TextComponent (and its
+ * layout) is only touched when needed. */
+class HudText {
+    public:
+        HudText();
+
+        // forget the displayed value: next set* reports a change
+        void reset();
+
+        // returns true if the text changed
+        bool setUnsigned(unsigned int value);
+        // "[m:]ss.t s"
+        bool setTime(float seconds);
+
+        const char* c_str() const { return buffer; }
+
+    private:
+        // what is displayed: the value, or the time in tenths of second
+        long long shown;
+        char buffer[24];
+};
@@ -0,0 +1,98 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "SceneFrameStats.h"
+
+#include <algorithm>
+#include <sstream>
+
+static const char* sceneNames[] = {
+    "CountDown",
+    "Delete",
+    "ElitePopup",
+    "AboutUsPopup",
+    "EndGame",
+    "ExitState",
+    "Fall",
+    "Help",
+    "LevelChanged",
+    "Logo",
+    "MainMenu",
+    "ModeMenu",
+    "Pause",
+    "RateIt",
+    "Spawn",
+    "UserInput",
+    "StartAt10",
+};
+
+SceneFrameStats::SceneFrameStats() {
+    for (int i=0; i<=Scene::StartAt10; i++)
+        samples[i].reserve(1024);
+}
+
+void SceneFrameStats::record(Scene::Enum scene, float seconds) {
+    samples[scene].push_back(seconds * 1000);
+}
+
+void SceneFrameStats::clear() {
+    for (int i=0; i<=Scene::StartAt10; i++)
+        samples[i].clear();
+}
+
+static float sortedPercentile(const std::vector<float>& sorted, float p) {
+    if (sorted.empty())
+        return 0;
+    const unsigned index = (unsigned)(p * (sorted.size() - 1) + 0.5f);
+    return sorted[std::min(index, (unsigned)sorted.size() - 1)];
+}
+
+float SceneFrameStats::percentile(Scene::Enum scene, float p) const {
+    std::vector<float> sorted(samples[scene]);
+    std::sort(sorted.begin(), sorted.end());
+    return sortedPercentile(sorted, p);
+}
+
+std::string SceneFrameStats::toJSON(float budgetMs) const {
+    std::stringstream ss;
+    ss.precision(3);
+    ss << std::fixed;
+    ss << "{\n  \"budget_ms\": " << budgetMs << ",\n  \"scenes\": [";
+
+    bool first = true;
+    for (int i=0; i<=Scene::StartAt10; i++) {
+        if (samples[i].empty())
+            continue;
+        std::vector<float> sorted(samples[i]);
+        std::sort(sorted.begin(), sorted.end());
+        const unsigned over = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(), budgetMs);
+
+        ss << (first ? "\n" : ",\n");
+        ss << "    {\"scene\": \"" << sceneNames[i] << "\", \"frames\": " << sorted.size()
+            << ", \"p50_ms\": " << sortedPercentile(sorted, 0.5f)
+            << ", \"p90_ms\": " << sortedPercentile(sorted, 0.9f)
+            << ", \"p99_ms\": " << sortedPercentile(sorted, 0.99f)
+            << ", \"max_ms\": " << sorted.back()
+            << ", \"over_budget\": " << over << "}";
+        first = false;
+    }
+    ss << "\n  ]\n}\n";
+    return ss.str();
+}
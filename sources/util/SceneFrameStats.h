@@ -0,0 +1,47 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "base/StateMachine.h"
+#include "states/Scenes.h"
+
+#include <string>
+#include <vector>
+
+/* Game thread frame durations, sorted by scene, to find which ones blow the frame budget */
+class SceneFrameStats {
+    public:
+        SceneFrameStats();
+
+        void record(Scene::Enum scene, float seconds);
+        void clear();
+
+        unsigned frameCount(Scene::Enum scene) const { return samples[scene].size(); }
+        // p in [0, 1]; milliseconds
+        float percentile(Scene::Enum scene, float p) const;
+
+        /* Per scene count, p50/p90/p99/max and frames over budget, as JSON */
+        std::string toJSON(float budgetMs = 1000 / 60.f) const;
+
+    private:
+        std::vector<float> samples[Scene::StartAt10 + 1];
+};
@@ -0,0 +1,195 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "SoakDriver.h"
+
+#include "util/ScoreStorageProxy.h"
+#include "systems/BackgroundSystem.h"
+#include "systems/HeriswapGridSystem.h"
+#include "systems/TwitchSystem.h"
+
+#include "api/StorageAPI.h"
+#include "base/Log.h"
+
+#include "systems/ADSRSystem.h"
+#include "systems/AnimationSystem.h"
+#include "systems/AutoDestroySystem.h"
+#include "systems/ButtonSystem.h"
+#include "systems/ContainerSystem.h"
+#include "systems/MorphingSystem.h"
+#include "systems/MusicSystem.h"
+#include "systems/ParticuleSystem.h"
+#include "systems/RenderingSystem.h"
+#include "systems/SoundSystem.h"
+#include "systems/TextSystem.h"
+#include "systems/TransformationSystem.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <malloc.h>
+#endif
+
+const float SoakDriver::MaxGameTime = 30 * 60;
+
+// seconds the bot waits before each move
+#define BOT_THINK_TIME 0.5f
+
+static unsigned envOr(const char* name, unsigned def) {
+    const char* value = getenv(name);
+    return value ? (unsigned)atoi(value) : def;
+}
+
+SoakDriver::SoakDriver() : timeScale(1), enabled(false), playing(false), finished(false),
+    gameCount(0), sampleEvery(20), played(0), storedScoresAtStart(-1), gameTime(0), untilNextMove(0),
+    random(0x50A4), growth(2, 0.1f, 16) {
+}
+
+bool SoakDriver::load() {
+    gameCount = envOr("HERISWAP_SOAK", 0);
+    if (gameCount == 0)
+        return false;
+    sampleEvery = envOr("HERISWAP_SOAK_SAMPLE", 20);
+    if (sampleEvery == 0)
+        sampleEvery = 1;
+    timeScale = (float)envOr("HERISWAP_SOAK_SPEED", 4);
+    if (timeScale < 1)
+        timeScale = 1;
+
+    LOGI("Soak test: " << gameCount << " games, sampled every " << sampleEvery << " games, time x" << timeScale);
+    enabled = true;
+    return true;
+}
+
+GameMode SoakDriver::nextMode() const {
+    return (GameMode)(played % 3);
+}
+
+Difficulty SoakDriver::nextDifficulty() const {
+    static const Difficulty difficulties[] = { DifficultyEasy, DifficultyMedium, DifficultyHard };
+    return difficulties[(played / 3) % 3];
+}
+
+void SoakDriver::gameStarted() {
+    playing = true;
+    gameTime = 0;
+    untilNextMove = BOT_THINK_TIME;
+}
+
+void SoakDriver::advance(float dt) {
+    gameTime += dt;
+    untilNextMove -= dt;
+}
+
+bool SoakDriver::pickSwap(const Board& board, BoardSwap& out) {
+    candidates.clear();
+    board.SwapsCreatingCombination(candidates);
+    if (candidates.empty())
+        return false;
+    out = candidates[random.Int(0, candidates.size() - 1)];
+    untilNextMove = BOT_THINK_TIME;
+    return true;
+}
+
+void SoakDriver::gameEnded(StorageAPI* storage) {
+    if (!playing)
+        return;
+    playing = false;
+    played++;
+
+    // first sample is the reference for the stored scores
+    if (played == 1 || played % sampleEvery == 0)
+        sample(storage);
+}
+
+template<class S>
+static void sampleEntities(GrowthTracker& growth, unsigned x, const char* name, S& system) {
+    growth.sample(x, std::string("entities_") + name, system.RetrieveAllEntityWithComponent().size());
+}
+
+void SoakDriver::sample(StorageAPI* storage) {
+#if defined(__linux__) || defined(__ANDROID__)
+    growth.sample(played, "heap_bytes", mallinfo().uordblks);
+#endif
+
+    sampleEntities(growth, played, "transformation", theTransformationSystem);
+    sampleEntities(growth, played, "rendering", theRenderingSystem);
+    sampleEntities(growth, played, "text", theTextSystem);
+    sampleEntities(growth, played, "button", theButtonSystem);
+    sampleEntities(growth, played, "sound", theSoundSystem);
+    sampleEntities(growth, played, "music", theMusicSystem);
+    sampleEntities(growth, played, "adsr", theADSRSystem);
+    sampleEntities(growth, played, "animation", theAnimationSystem);
+    sampleEntities(growth, played, "autodestroy", theAutoDestroySystem);
+    sampleEntities(growth, played, "container", theContainerSystem);
+    sampleEntities(growth, played, "morphing", theMorphingSystem);
+    sampleEntities(growth, played, "particule", theParticuleSystem);
+    sampleEntities(growth, played, "heriswapgrid", theHeriswapGridSystem);
+    sampleEntities(growth, played, "twitch", theTwitchSystem);
+    sampleEntities(growth, played, "background", theBackgroundSystem);
+
+    // distinct resources still referenced by a component
+    std::set<TextureRef> textures;
+    theRenderingSystem.forEachECDo([&textures] (Entity, RenderingComponent* rc) -> void {
+        textures.insert(rc->texture);
+    });
+    growth.sample(played, "texture_refs", textures.size());
+    std::set<SoundRef> sounds;
+    theSoundSystem.forEachECDo([&sounds] (Entity, SoundComponent* sc) -> void {
+        sounds.insert(sc->sound);
+    });
+    growth.sample(played, "sound_refs", sounds.size());
+
+    // soak games are never stored: any new score is a leak
+    ScoreStorageProxy ssp;
+    const int stored = storage->count(&ssp, "*", "");
+    if (storedScoresAtStart < 0)
+        storedScoresAtStart = stored;
+    growth.sample(played, "stored_scores_extra", stored - storedScoresAtStart);
+
+    LOGI("Soak test: " << played << "/" << gameCount << " games played");
+}
+
+bool SoakDriver::finish() {
+    if (finished)
+        return false;
+    finished = true;
+
+    const std::string report = growth.toJSON();
+    const char* path = getenv("HERISWAP_SOAK_REPORT");
+    if (path) {
+        std::ofstream out(path);
+        out << report;
+    } else {
+        LOGI("Soak report:\n" << report);
+    }
+
+    const std::vector<std::string> growing = growth.growing();
+    std::stringstream names;
+    for (unsigned i=0; i<growing.size(); i++)
+        names << " " << growing[i];
+    LOGF_IF(!growing.empty(), "Soak test failed, unbounded growth:" << names.str());
+    LOGI("Soak test passed: " << played << " games");
+    return true;
+}
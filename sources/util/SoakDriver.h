@@ -0,0 +1,88 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "modes/GameMode.h"
+#include "sim/Board.h"
+#include "sim/SeededRandom.h"
+#include "util/GrowthTracker.h"
+
+#include <vector>
+
+class StorageAPI;
+
+/* Plays games back to back with a bot, on accelerated time, and samples every few
+ * games what should stay bounded: heap, live entities per system, textures and
+ * sounds referenced by components, stored scores (bot games are neither stored
+ * nor sent to GameCenter, the count must not move). Once done, the samples are
+ * reported and the game aborts if anything keeps growing.
+ *
+ * Enabled by HERISWAP_SOAK (number of games). Optional: HERISWAP_SOAK_SAMPLE
+ * (games between samples, 20), HERISWAP_SOAK_SPEED (time scale, 4) and
+ * HERISWAP_SOAK_REPORT (report path, the log if unset). */
+class SoakDriver {
+    public:
+        SoakDriver();
+
+        bool load();
+        bool active() const { return enabled; }
+
+        // multiplier applied to the frame dt
+        float timeScale;
+
+        // a new game has to be started, with these settings
+        bool wantsNewGame() const { return enabled && !playing && played < gameCount; }
+        GameMode nextMode() const;
+        Difficulty nextDifficulty() const;
+        void gameStarted();
+
+        // to be called each frame with the mode clock progression
+        void advance(float dt);
+
+        // the bot is done thinking
+        bool moveDue() const { return untilNextMove <= 0; }
+        bool pickSwap(const Board& board, BoardSwap& out);
+        bool pickDifficultyChange() { return random.Int(0, 1) == 1; }
+        // Normal mode can last forever with a lucky bot
+        bool gameTooLong() const { return gameTime > MaxGameTime; }
+
+        /* Back in the menu: takes a sample if it's time to */
+        void gameEnded(StorageAPI* storage);
+        bool done() const { return enabled && played >= gameCount; }
+
+        /* Write the report, abort on unbounded growth. Returns false if it was already done */
+        bool finish();
+
+    private:
+        void sample(StorageAPI* storage);
+
+        static const float MaxGameTime;
+
+        bool enabled, playing, finished;
+        unsigned gameCount, sampleEvery, played;
+        int storedScoresAtStart;
+        float gameTime, untilNextMove;
+        SeededRandom random;
+        std::vector<BoardSwap> candidates;
+        GrowthTracker growth;
+};
@@ -0,0 +1,169 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "SwapLatency.h"
+
+#include <cstring>
+#include <sstream>
+
+const float SwapLatency::bucketLimitsMs[BucketCount - 1] = { 8, 16, 33, 50, 100, 200, 500 };
+
+static const char* segmentNames[] = { "gesture", "animation", "rollback", "deletion", "total" };
+static const char* difficultyNames[] = { "easy", "medium", "hard" };
+
+SwapLatency::SwapLatency() {
+    clear();
+}
+
+int SwapLatency::index(Difficulty difficulty) {
+    switch (difficulty) {
+        case DifficultyEasy: return 0;
+        case DifficultyMedium: return 1;
+        default: return 2;
+    }
+}
+
+void SwapLatency::touchDown(float time) {
+    down = time;
+    release = detection = shown = -1;
+}
+
+void SwapLatency::released(float time) {
+    release = time;
+}
+
+void SwapLatency::detected(float time, bool kept, Difficulty difficulty) {
+    if (release < 0)
+        return;
+    detection = time;
+    if (!kept)
+        rolledBack[index(difficulty)]++;
+}
+
+void SwapLatency::automatedSwap(float time) {
+    down = -1;
+    release = detection = time;
+}
+
+void SwapLatency::swapShown(float time) {
+    if (detection >= 0)
+        shown = time;
+}
+
+void SwapLatency::rollbackEnded(float time, Difficulty difficulty) {
+    if (detection < 0)
+        return;
+    const int d = index(difficulty);
+    if (down >= 0)
+        add(d, Gesture, release - down);
+    add(d, Rollback, time - detection);
+    drop();
+}
+
+void SwapLatency::deletionStarted(float time, Difficulty difficulty) {
+    if (shown < 0)
+        return;
+    const int d = index(difficulty);
+    if (down >= 0)
+        add(d, Gesture, release - down);
+    add(d, Animation, shown - detection);
+    add(d, Deletion, time - shown);
+    add(d, Total, time - (down >= 0 ? down : detection));
+    drop();
+}
+
+void SwapLatency::drop() {
+    down = release = detection = shown = -1;
+}
+
+void SwapLatency::clear() {
+    drop();
+    memset(histograms, 0, sizeof(histograms));
+    memset(rolledBack, 0, sizeof(rolledBack));
+}
+
+void SwapLatency::add(int difficulty, Segment segment, float seconds) {
+    Histogram& h = histograms[difficulty][segment];
+    const float ms = seconds * 1000;
+    int b = 0;
+    while (b < BucketCount - 1 && ms >= bucketLimitsMs[b])
+        b++;
+    h.buckets[b]++;
+    h.count++;
+    h.sumMs += ms;
+    if (ms > h.maxMs)
+        h.maxMs = ms;
+}
+
+const SwapLatency::Histogram& SwapLatency::histogram(Difficulty difficulty, Segment segment) const {
+    return histograms[index(difficulty)][segment];
+}
+
+std::string SwapLatency::toJSON() const {
+    std::stringstream ss;
+    ss << "{\"bucket_limits_ms\": [";
+    for (int b=0; b<BucketCount - 1; b++)
+        ss << (b ? ", " : "") << bucketLimitsMs[b];
+    ss << "], \"difficulties\": [";
+    ss.precision(3);
+    ss << std::fixed;
+
+    bool first = true;
+    for (int d=0; d<3; d++) {
+        if (!histograms[d][Total].count && !rolledBack[d])
+            continue;
+        ss << (first ? "\n" : ",\n");
+        ss << "    {\"difficulty\": \"" << difficultyNames[d] << "\", \"rollbacks\": " << rolledBack[d];
+        for (int s=0; s<SegmentCount; s++) {
+            const Histogram& h = histograms[d][s];
+            ss << ", \"" << segmentNames[s] << "\": {\"count\": " << h.count
+                << ", \"mean_ms\": " << (h.count ? h.sumMs / h.count : 0.f)
+                << ", \"max_ms\": " << h.maxMs << ", \"buckets\": [";
+            for (int b=0; b<BucketCount; b++)
+                ss << (b ? ", " : "") << h.buckets[b];
+            ss << "]}";
+        }
+        ss << "}";
+        first = false;
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+std::string SwapLatency::summary() const {
+    std::stringstream ss;
+    ss.precision(1);
+    ss << std::fixed;
+    for (int d=0; d<3; d++) {
+        if (!histograms[d][Total].count && !rolledBack[d])
+            continue;
+        ss << difficultyNames[d] << ":";
+        for (int s=Animation; s<SegmentCount; s++) {
+            const Histogram& h = histograms[d][s];
+            if (!h.count)
+                continue;
+            ss << " " << segmentNames[s] << " " << (h.count ? h.sumMs / h.count : 0.f) << "/" << h.maxMs << "ms";
+        }
+        ss << " (" << histograms[d][Total].count << " swaps, " << rolledBack[d] << " rollbacks)\n";
+    }
+    return ss.str();
+}
@@ -0,0 +1,89 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "sim/Board.h"
+
+#include <string>
+
+/* Where the time goes between the player's gesture and the leaves vanishing.
+ * Each swap goes through: touch down, detection (the swipe crosses the threshold
+ * toward the swapped leaf), release (finger up), swap shown (leaves exchanged on
+ * release, or back in place once the rollback animation is over), deletion start
+ * (first DeleteScene frame shrinking leaves). Times come from TimeUtil::GetTime();
+ * durations are aggregated per difficulty.
+ * Touch times are those of the events: with the per-frame touch sampling they are
+ * the frame which saw the touch, see TouchEventQueue. */
+class SwapLatency {
+    public:
+        enum Segment {
+            Gesture,    // touch down -> release
+            Animation,  // detection -> swap shown, kept swaps (0 if automated)
+            Rollback,   // detection -> leaves back in place, rolled back swaps
+            Deletion,   // swap shown -> deletion start
+            Total,      // touch down (detection if automated) -> deletion start
+            SegmentCount
+        };
+        // bucket i counts durations below bucketLimitsMs[i]; the last one is unbounded
+        static const int BucketCount = 8;
+        static const float bucketLimitsMs[BucketCount - 1];
+
+        struct Histogram {
+            unsigned int buckets[BucketCount];
+            unsigned int count;
+            float sumMs, maxMs;
+        };
+
+        SwapLatency();
+
+        void touchDown(float time);
+        void released(float time);
+        // 'kept': false if the swap is rolled back, the trace ends with rollbackEnded()
+        void detected(float time, bool kept, Difficulty difficulty);
+        // swap decided by a script or a bot: no gesture, detected right now
+        void automatedSwap(float time);
+        void swapShown(float time);
+        void rollbackEnded(float time, Difficulty difficulty);
+        void deletionStarted(float time, Difficulty difficulty);
+        // the swap being traced won't reach its end (scene left meanwhile)
+        void drop();
+
+        void clear();
+
+        const Histogram& histogram(Difficulty difficulty, Segment segment) const;
+        unsigned int rollbacks(Difficulty difficulty) const { return rolledBack[index(difficulty)]; }
+
+        /* Per difficulty and segment count, mean, max and buckets, as JSON */
+        std::string toJSON() const;
+        /* Short summary for the log */
+        std::string summary() const;
+
+    private:
+        static int index(Difficulty difficulty);
+        void add(int difficulty, Segment segment, float seconds);
+
+        // timestamps of the swap being traced (< 0: not reached)
+        float down, release, detection, shown;
+        Histogram histograms[3][SegmentCount];
+        unsigned int rolledBack[3];
+};
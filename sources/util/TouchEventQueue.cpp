@@ -0,0 +1,107 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "TouchEventQueue.h"
+
+TouchEventQueue::TouchEventQueue() : down(false), last(0.f) {
+}
+
+void TouchEventQueue::post(const TouchEvent& e) {
+    std::lock_guard<std::mutex> lock(postedMutex);
+    posted.push_back(e);
+}
+
+bool TouchEventQueue::takePosted() {
+    {
+        std::lock_guard<std::mutex> lock(postedMutex);
+        // the two buffers keep their capacity, no allocation once warm
+        taken.swap(posted);
+    }
+    if (taken.empty())
+        return false;
+    for (unsigned i=0; i<taken.size(); i++)
+        push(taken[i]);
+    taken.clear();
+    return true;
+}
+
+void TouchEventQueue::push(const TouchEvent& e) {
+    events.push_back(e);
+    down = (e.type != TouchEvent::Up);
+    last = e.position;
+}
+
+bool TouchEventQueue::pop(TouchEvent& e) {
+    if (events.empty())
+        return false;
+    e = events.front();
+    events.pop_front();
+    return true;
+}
+
+void TouchEventQueue::clear() {
+    events.clear();
+    std::lock_guard<std::mutex> lock(postedMutex);
+    posted.clear();
+}
+
+void TouchEventQueue::sample(bool touched, const glm::vec2& position, float time) {
+    if (touched) {
+        if (!down) {
+            TouchEvent e = { TouchEvent::Down, position, time };
+            push(e);
+        } else if (position != last) {
+            TouchEvent e = { TouchEvent::Move, position, time };
+            push(e);
+        }
+    } else if (down) {
+        TouchEvent e = { TouchEvent::Up, last, time };
+        push(e);
+    }
+}
+
+SwipeTracker::SwipeTracker() : direction(0), intentTime(0), origin(0.f), threshold(0) {
+}
+
+void SwipeTracker::begin(const glm::vec2& o, float t) {
+    origin = o;
+    threshold = t;
+    direction = glm::ivec2(0);
+    intentTime = 0;
+}
+
+bool SwipeTracker::feed(const TouchEvent& e) {
+    const glm::vec2 move = e.position - origin;
+
+    glm::ivec2 dir(0);
+    if (glm::dot(move, move) >= threshold) {
+        if (glm::abs(move.x) > glm::abs(move.y))
+            dir.x = (move.x < 0) ? -1 : 1;
+        else
+            dir.y = (move.y < 0) ? -1 : 1;
+    }
+    if (dir == direction)
+        return false;
+    direction = dir;
+    intentTime = e.time;
+    return true;
+}
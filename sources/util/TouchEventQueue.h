@@ -0,0 +1,92 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+struct TouchEvent {
+    enum Type { Down, Move, Up } type;
+    glm::vec2 position;
+    // TimeUtil::GetTime() when it happened, or when sampled
+    float time;
+};
+
+/* Touch events of the first finger, in the order they happened. Platforms able to
+ * report every event post() them from their input thread, stamped with the
+ * platform event time converted to the TimeUtil clock: a flick shorter than a
+ * frame keeps its down, moves and up. Each frame takePosted() hands them to the
+ * game thread; only if none arrived does sample() turn the touch manager state
+ * into events, stamped with the frame time.
+ * sac's touch manager is polled, so without such a platform the queue is fed by
+ * sample() alone: one event per frame at most, sub-frame flicks are lost. */
+class TouchEventQueue {
+    public:
+        TouchEventQueue();
+
+        // any thread
+        void post(const TouchEvent& e);
+
+        // game thread: queue the posted events, false if there was none
+        bool takePosted();
+        // per-frame fallback: state of the finger at 'time'
+        void sample(bool touched, const glm::vec2& position, float time);
+        bool pop(TouchEvent& e);
+        // drops posted events too
+        void clear();
+
+    private:
+        void push(const TouchEvent& e);
+
+        std::deque<TouchEvent> events;
+        // last state given to the game thread, sample() only reports changes
+        bool down;
+        glm::vec2 last;
+
+        std::mutex postedMutex;
+        std::vector<TouchEvent> posted, taken;
+};
+
+/* Follows the finger from down to up and tells toward which neighbour it swipes.
+ * Every event of the path is looked at, so the intent is known at the event
+ * crossing the threshold, not at the next frame. */
+class SwipeTracker {
+    public:
+        SwipeTracker();
+
+        void begin(const glm::vec2& origin, float threshold);
+        // true if the swipe direction changed with this event
+        bool feed(const TouchEvent& e);
+
+        // (0,0) while under the threshold, else one of the 4 axis directions
+        glm::ivec2 direction;
+        // time of the event which gave the current direction
+        float intentTime;
+        glm::vec2 origin;
+
+    private:
+        float threshold;
+};
@@ -0,0 +1,100 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "TwitchBatch.h"
+
+#include <cmath>
+
+void TwitchBatch::clear() {
+    rotation.clear();
+    minAngle.clear();
+    maxAngle.clear();
+    variance.clear();
+    speed.clear();
+    side.clear();
+    currentVariance.clear();
+}
+
+void TwitchBatch::reserve(unsigned count) {
+    rotation.reserve(count);
+    minAngle.reserve(count);
+    maxAngle.reserve(count);
+    variance.reserve(count);
+    speed.reserve(count);
+    side.reserve(count);
+    currentVariance.reserve(count);
+    noise.reserve(count);
+}
+
+unsigned TwitchBatch::add(float rot, float min, float max, float var, float spd, int s, float currentVar) {
+    rotation.push_back(rot);
+    minAngle.push_back(min);
+    maxAngle.push_back(max);
+    variance.push_back(var);
+    speed.push_back(spd);
+    side.push_back(s ? 1.f : 0.f);
+    currentVariance.push_back(currentVar);
+    return rotation.size() - 1;
+}
+
+void TwitchBatch::update(float dt, SeededRandom& random) {
+    const unsigned count = rotation.size();
+    if (!count)
+        return;
+
+    // one draw per frame, spread over the entries by a hash (no dependency from an
+    // entry to the next, unlike a generator sequence)
+    noise.resize(count);
+    float* __restrict n = &noise[0];
+    const uint32_t frameSeed = random.next();
+    for (unsigned k=0; k<count; k++) {
+        uint32_t x = frameSeed + k * 0x9E3779B9u;
+        x ^= x >> 16;
+        x *= 0x7FEB352Du;
+        x ^= x >> 15;
+        x *= 0x846CA68Bu;
+        x ^= x >> 16;
+        n[k] = (x >> 8) * (2.f / 16777216.f) - 1;
+    }
+
+    // arrays don't overlap: lets the compiler vectorize without runtime checks
+    float* __restrict rot = &rotation[0];
+    float* __restrict s = &side[0];
+    float* __restrict cv = &currentVariance[0];
+    const float* __restrict mn = &minAngle[0];
+    const float* __restrict mx = &maxAngle[0];
+    const float* __restrict var = &variance[0];
+    const float* __restrict spd = &speed[0];
+    for (unsigned k=0; k<count; k++) {
+        const float target = mn[k] + (mx[k] - mn[k]) * s[k] + cv[k];
+        const float diff = target - rot[k];
+        const float step = spd[k] * dt;
+        // 1 if the target is reached this frame, 0 otherwise (a sign, not a test:
+        // compilers turn the comparison into a jump)
+        const float reached = 0.5f + 0.5f * std::copysign(1.f, step - std::fabs(diff));
+        // reached: snap to the target, else move proportionally to the distance
+        rot[k] += diff * (reached + (1 - reached) * step);
+        // reached: turn back, with a new variance
+        s[k] += reached * (1 - 2 * s[k]);
+        cv[k] += reached * (n[k] * var[k] - cv[k]);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include "sim/SeededRandom.h"
+
+#include <vector>
+
+/* Twitch animations of many entities in parallel arrays (see TwitchSystem): one
+ * update is a few straight loops without branch, that the compiler can vectorize.
+ * Engine-free, so it can be benchmarked offline (tools/heriswap_bench). */
+class TwitchBatch {
+    public:
+        void clear();
+        void reserve(unsigned count);
+        // returns the entry index. 'side': 0 going to minAngle, 1 to maxAngle
+        unsigned add(float rotation, float minAngle, float maxAngle, float variance, float speed, int side, float currentVariance);
+        unsigned size() const { return rotation.size(); }
+
+        /* Move every entry toward its target; when reached, turn back with a new
+         * variance. 'random' is drawn once per frame, and hashed for each entry */
+        void update(float dt, SeededRandom& random);
+
+        std::vector<float> rotation;
+        std::vector<float> minAngle, maxAngle;
+        std::vector<float> variance, speed;
+        // 0 or 1, as float to blend without branch
+        std::vector<float> side;
+        std::vector<float> currentVariance;
+
+    private:
+        // uniform draws in [-1, 1], one per entry
+        std::vector<float> noise;
+};
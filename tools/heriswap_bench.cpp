@@ -0,0 +1,325 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Grid hot paths microbenchmarks. Boards come from fixed seeds, so results can be
+ * compared between commits. Output is JSON, one entry per (operation, grid size),
+ * then the twitch animation update per twitching entities count.
+ *
+ * Only the Board versions of the grid operations are timed: HeriswapGridSystem
+ * (GetSwapCombinations, LookForCombination, StillCombinations) works on engine
+ * components, which can't be built in a standalone tool. The Board ones apply
+ * the same rules to the same grids, without the component lookups on top.
+ *
+ * usage: heriswap_bench [--filter name] [--min-time ms]
+ */
+
+#include "sim/Board.h"
+#include "sim/SeededRandom.h"
+#include "util/TwitchBatch.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+///--------------------- allocations counting --------------------------------//
+static std::atomic<unsigned long long> allocations(0);
+
+// every new/delete form is replaced, so that they all pair with malloc/free
+static void* countedAlloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+static void countedFree(void* p) noexcept {
+    free(p);
+}
+
+void* operator new(size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+    return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void* p) noexcept {
+    countedFree(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    countedFree(p);
+}
+
+///--------------------- boards corpora --------------------------------------//
+#define CORPUS_SIZE 64
+
+// 5/6/8 are the real grids, bigger ones show how the algorithms scale
+static const int gridSizes[] = { 5, 6, 8, 16, 32 };
+
+static int typesForSize(int size) {
+    return (size <= 8) ? size : 8;
+}
+
+// random types: full of combinations
+static std::vector<Board> randomBoards(int size) {
+    SeededRandom random(0xB0A2D + size);
+    std::vector<Board> boards(CORPUS_SIZE, Board(size, typesForSize(size)));
+    for (unsigned b=0; b<boards.size(); b++) {
+        for (int i=0; i<size; i++)
+            for (int j=0; j<size; j++)
+                boards[b].set(i, j, random.Int(0, typesForSize(size) - 1));
+    }
+    return boards;
+}
+
+// as the player sees them: no direct combination
+static std::vector<Board> settledBoards(int size) {
+    SeededRandom random(0x5E771ED + size);
+    std::vector<Board> boards(CORPUS_SIZE, Board(size, typesForSize(size)));
+    std::vector<BoardCell> cells;
+    for (unsigned b=0; b<boards.size(); b++)
+        boards[b].FillTheBlank(random, cells);
+    return boards;
+}
+
+// combinations removed, leaves not fallen yet
+static std::vector<Board> holedBoards(int size) {
+    std::vector<Board> boards = randomBoards(size);
+    for (unsigned b=0; b<boards.size(); b++)
+        boards[b].Remove(boards[b].LookForCombination());
+    return boards;
+}
+
+// fallen leaves, empty cells on top of columns
+static std::vector<Board> fallenBoards(int size) {
+    std::vector<Board> boards = holedBoards(size);
+    for (unsigned b=0; b<boards.size(); b++)
+        boards[b].ApplyFall(boards[b].TileFall());
+    return boards;
+}
+
+///--------------------- runner ----------------------------------------------//
+struct Result {
+    std::string name;
+    // grid size, or entities count
+    const char* sizeName;
+    int size;
+    unsigned long long iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+typedef std::function<void (Board&, SeededRandom&)> Operation;
+
+/* Run 'op' on copies of the corpus boards until 'minTime' is spent.
+ * Copies are made out of the timed sections, so ops may modify boards */
+static Result bench(const std::string& name, int size, const std::vector<Board>& corpus, const Operation& op, double minTime) {
+    typedef std::chrono::steady_clock Clock;
+    SeededRandom random(0xBE7C4 + size);
+    std::vector<Board> work;
+
+    double elapsed = 0;
+    unsigned long long iterations = 0, allocs = 0;
+    while (elapsed < minTime) {
+        work = corpus;
+
+        const unsigned long long allocsBefore = allocations.load();
+        const Clock::time_point begin = Clock::now();
+        for (unsigned b=0; b<work.size(); b++)
+            op(work[b], random);
+        elapsed += std::chrono::duration<double>(Clock::now() - begin).count();
+        allocs += allocations.load() - allocsBefore;
+
+        iterations += work.size();
+    }
+
+    Result r;
+    r.name = name;
+    r.sizeName = "grid_size";
+    r.size = size;
+    r.iterations = iterations;
+    r.nsPerOp = elapsed * 1e9 / iterations;
+    r.allocsPerOp = allocs / (double)iterations;
+    return r;
+}
+
+// keep results alive so the compiler doesn't remove the work
+static volatile size_t sink;
+
+///--------------------- twitch animation -----------------------------------//
+// every cell of the 8x8 grid and the branch leaves, up to many more
+static const int twitchCounts[] = { 64, 128, 512, 2048 };
+
+static TwitchBatch twitchingEntities(int count) {
+    SeededRandom random(0x7317C4 + count);
+    TwitchBatch batch;
+    for (int i=0; i<count; i++) {
+        // as CombinationMark::markCellInCombination
+        const float angle = random.Float(-0.5f, 0.5f);
+        batch.add(angle, angle - 0.4f, angle + 0.4f, random.Float(0, 0.2f), random.Float(10, 15), random.Int(0, 1), 0);
+    }
+    return batch;
+}
+
+// the update as it was done component by component, for comparison
+static void twitchScalar(TwitchBatch& b, float dt, SeededRandom& random) {
+    for (unsigned k=0; k<b.size(); k++) {
+        const float target = (b.side[k] == 0) ? (b.minAngle[k] + b.currentVariance[k]) : (b.maxAngle[k] + b.currentVariance[k]);
+        if (b.speed[k] * dt > std::fabs(target - b.rotation[k])) {
+            b.rotation[k] = target;
+            b.side[k] = 1 - b.side[k];
+            b.currentVariance[k] = random.Float(-b.variance[k], b.variance[k]);
+        } else {
+            b.rotation[k] += (target - b.rotation[k]) * b.speed[k] * dt;
+        }
+    }
+}
+
+/* 60 fps frames of 'count' twitching entities, until 'minTime' is spent */
+static Result benchTwitch(const std::string& name, int count, bool batched, double minTime) {
+    typedef std::chrono::steady_clock Clock;
+    SeededRandom random(0xBE7C4 + count);
+    TwitchBatch batch = twitchingEntities(count);
+    const float dt = 1 / 60.f;
+
+    double elapsed = 0;
+    unsigned long long iterations = 0, allocs = 0;
+    while (elapsed < minTime) {
+        const unsigned long long allocsBefore = allocations.load();
+        const Clock::time_point begin = Clock::now();
+        for (int f=0; f<64; f++) {
+            if (batched)
+                batch.update(dt, random);
+            else
+                twitchScalar(batch, dt, random);
+        }
+        elapsed += std::chrono::duration<double>(Clock::now() - begin).count();
+        allocs += allocations.load() - allocsBefore;
+        iterations += 64;
+    }
+    sink = (size_t)(batch.rotation[0] * 1000);
+
+    Result r;
+    r.name = name;
+    r.sizeName = "entities";
+    r.size = count;
+    r.iterations = iterations;
+    r.nsPerOp = elapsed * 1e9 / iterations;
+    r.allocsPerOp = allocs / (double)iterations;
+    return r;
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    double minTime = 0.2;
+    for (int i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+            filter = argv[++i];
+        else if (!strcmp(argv[i], "--min-time") && i + 1 < argc)
+            minTime = atof(argv[++i]) / 1000.;
+    }
+
+    std::vector<Result> results;
+    for (unsigned s=0; s<sizeof(gridSizes) / sizeof(gridSizes[0]); s++) {
+        const int size = gridSizes[s];
+        const std::vector<Board> random = randomBoards(size);
+        const std::vector<Board> settled = settledBoards(size);
+        const std::vector<Board> holed = holedBoards(size);
+        const std::vector<Board> fallen = fallenBoards(size);
+
+        std::vector<std::vector<Combinais> > lines;
+        for (unsigned b=0; b<random.size(); b++)
+            lines.push_back(random[b].LookForLines());
+        unsigned nextLines = 0;
+
+        struct {
+            const char* name;
+            const std::vector<Board>* corpus;
+            Operation op;
+        } benchmarks[] = {
+            { "LookForCombination", &random, [] (Board& b, SeededRandom&) {
+                sink = b.LookForCombination().size();
+            }},
+            { "MergeCombination", &random, [&lines, &nextLines] (Board&, SeededRandom&) {
+                sink = Board::MergeCombination(lines[nextLines++ % lines.size()]).size();
+            }},
+            { "TileFall", &holed, [] (Board& b, SeededRandom&) {
+                sink = b.TileFall().size();
+            }},
+            { "StillCombinations", &settled, [] (Board& b, SeededRandom&) {
+                sink = b.StillCombinations();
+            }},
+            { "SwapsCreatingCombination", &settled, [] (Board& b, SeededRandom&) {
+                std::vector<BoardSwap> swaps;
+                b.SwapsCreatingCombination(swaps);
+                sink = swaps.size();
+            }},
+            { "FillTheBlank", &fallen, [] (Board& b, SeededRandom& r) {
+                std::vector<BoardCell> cells;
+                b.FillTheBlank(r, cells);
+                sink = cells.size();
+            }},
+            { "RemoveCombinations", &random, [] (Board& b, SeededRandom& r) {
+                std::vector<BoardCell> cells;
+                b.RemoveCombinations(r, cells);
+                sink = cells.size();
+            }},
+        };
+
+        for (unsigned k=0; k<sizeof(benchmarks) / sizeof(benchmarks[0]); k++) {
+            if (!filter.empty() && std::string(benchmarks[k].name).find(filter) == std::string::npos)
+                continue;
+            results.push_back(bench(benchmarks[k].name, size, *benchmarks[k].corpus, benchmarks[k].op, minTime));
+        }
+    }
+
+    for (unsigned c=0; c<sizeof(twitchCounts) / sizeof(twitchCounts[0]); c++) {
+        if (filter.empty() || std::string("TwitchUpdate").find(filter) != std::string::npos)
+            results.push_back(benchTwitch("TwitchUpdate", twitchCounts[c], true, minTime));
+        if (filter.empty() || std::string("TwitchUpdateScalar").find(filter) != std::string::npos)
+            results.push_back(benchTwitch("TwitchUpdateScalar", twitchCounts[c], false, minTime));
+    }
+
+    printf("{\n  \"benchmarks\": [\n");
+    for (unsigned i=0; i<results.size(); i++) {
+        const Result& r = results[i];
+        printf("    {\"name\": \"%s\", \"%s\": %d, \"iterations\": %llu, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f}%s\n",
+            r.name.c_str(), r.sizeName, r.size, r.iterations, r.nsPerOp, r.allocsPerOp, (i + 1 < results.size()) ? "," : "");
+    }
+    printf("  ]\n}\n");
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Runs many bot-played games side by side in one process and reports throughput
+ * and per-session memory.
+ *
+ * usage: heriswap_host [sessions] [threads] [--scaling]
+ *   --scaling: run the same sessions with 1, 2, 4... threads up to 'threads'
+ * Throughput counts the frames of sessions still playing only.
+ */
+
+#include "sim/SessionHost.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+static const float FrameDt = 1 / 60.f;
+// frames run by a session per dispatch
+static const unsigned FramesPerStep = 60;
+
+static double run(unsigned sessionCount, unsigned threadCount, bool report) {
+    SessionHost host(threadCount);
+
+    static const Difficulty difficulties[] = { DifficultyEasy, DifficultyMedium, DifficultyHard };
+    for (unsigned i=0; i<sessionCount; i++)
+        host.addSession((GameMode)(i % 3), difficulties[(i / 3) % 3], 1 + i);
+
+    const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+    unsigned frames = 0;
+    // Normal mode can last forever with a lucky bot: stop at 30 minutes of game
+    while (!host.allFinished() && frames < 30 * 60 * 60) {
+        host.step(FrameDt, FramesPerStep);
+        frames += FramesPerStep;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (report) {
+        size_t total = 0, biggest = 0;
+        unsigned moves = 0;
+        double sessionFrames = 0;
+        for (unsigned i=0; i<host.sessionCount(); i++) {
+            const size_t m = host.session(i).memoryUsage();
+            total += m;
+            biggest = (m > biggest) ? m : biggest;
+            moves += host.session(i).game.moves;
+            sessionFrames += host.session(i).frames;
+        }
+        std::cout << "sessions: " << sessionCount << ", threads: " << host.threads() << std::endl;
+        std::cout << "frames: " << frames << " (" << frames * FrameDt << " s of game time)" << std::endl;
+        std::cout << "moves: " << moves << std::endl;
+        std::cout << "wall time: " << seconds << " s, " << sessionFrames / seconds << " session-frames/s" << std::endl;
+        std::cout << "memory per session: " << total / (sessionCount ? sessionCount : 1) << " bytes avg, " << biggest << " bytes max" << std::endl;
+    }
+    return seconds;
+}
+
+static int usage(const char* name) {
+    std::cerr << "usage: " << name << " [sessions] [threads] [--scaling]" << std::endl;
+    return 1;
+}
+
+// strictly positive integer
+static bool parseCount(const char* s, unsigned& out) {
+    char* end;
+    const long v = strtol(s, &end, 10);
+    if (*s == '\0' || *end != '\0' || v <= 0)
+        return false;
+    out = (unsigned)v;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    unsigned sessionCount = 64;
+    unsigned threadCount = std::thread::hardware_concurrency();
+    bool scaling = false;
+
+    int positional = 0;
+    for (int i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "--scaling"))
+            scaling = true;
+        else if (argv[i][0] == '-')
+            return usage(argv[0]);
+        else if (!parseCount(argv[i], positional++ == 0 ? sessionCount : threadCount) || positional > 2)
+            return usage(argv[0]);
+    }
+    if (threadCount == 0)
+        threadCount = 1;
+
+    if (!scaling) {
+        run(sessionCount, threadCount, true);
+        return 0;
+    }
+
+    const double reference = run(sessionCount, 1, true);
+    for (unsigned t=2; t<=threadCount; t *= 2) {
+        const double seconds = run(sessionCount, t, false);
+        std::cout << t << " threads: " << seconds << " s, speedup " << reference / seconds << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* Plays thousands of bot games back to back in the same objects, sampling the
+ * heap and the game memory every few games, and fails if any of them keeps
+ * growing. The in-game counterpart (entities, textures, storage) is enabled with
+ * HERISWAP_SOAK, see SoakDriver.
+ *
+ * usage: heriswap_soak [games] [--sample N] [--dt seconds]
+ */
+
+#include "sim/SessionHost.h"
+#include "util/GrowthTracker.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+///--------------------- heap tracking ---------------------------------------//
+static std::atomic<long long> liveBytes(0), liveBlocks(0);
+
+// keeps the block size in front of it, aligned for any type
+union BlockHeader {
+    size_t size;
+    max_align_t align;
+};
+
+void* operator new(size_t size) {
+    BlockHeader* h = (BlockHeader*)malloc(sizeof(BlockHeader) + size);
+    if (!h)
+        throw std::bad_alloc();
+    h->size = size;
+    liveBytes += size;
+    liveBlocks++;
+    return h + 1;
+}
+
+void operator delete(void* p) noexcept {
+    if (!p)
+        return;
+    BlockHeader* h = (BlockHeader*)p - 1;
+    liveBytes -= h->size;
+    liveBlocks--;
+    free(h);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+
+///--------------------- soak ------------------------------------------------//
+// Normal mode can last forever with a lucky bot
+static const float MaxGameTime = 30 * 60;
+
+int main(int argc, char** argv) {
+    unsigned games = 2000, sampleEvery = 50;
+    // bigger steps than a real frame: animations are instant here anyway
+    float dt = 0.25f;
+    for (int i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "--sample") && i + 1 < argc)
+            sampleEvery = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--dt") && i + 1 < argc)
+            dt = atof(argv[++i]);
+        else
+            games = atoi(argv[i]);
+    }
+    if (sampleEvery == 0)
+        sampleEvery = 1;
+
+    static const Difficulty difficulties[] = { DifficultyEasy, DifficultyMedium, DifficultyHard };
+    GrowthTracker growth(2, 0.1f, 1024);
+    // the samples live in the tracked heap too
+    growth.reserve(games / sampleEvery, 3);
+    HostedSession* session = new HostedSession();
+    unsigned long long moves = 0;
+
+    for (unsigned g=0; g<games; g++) {
+        session->botRandom.seed(~g);
+        session->thinkTime = session->untilNextMove = 0.5f;
+        session->finished = false;
+        session->game.start((GameMode)(g % 3), difficulties[(g / 3) % 3], 1 + g);
+        while (!session->finished && session->game.time < MaxGameTime)
+            session->step(dt);
+        moves += session->game.moves;
+
+        if ((g + 1) % sampleEvery == 0) {
+            growth.sample(g + 1, "heap_bytes", liveBytes.load());
+            growth.sample(g + 1, "heap_blocks", liveBlocks.load());
+            growth.sample(g + 1, "session_bytes", session->memoryUsage());
+        }
+    }
+    delete session;
+
+    std::cout << growth.toJSON();
+    std::cerr << games << " games, " << moves << " moves" << std::endl;
+
+    const std::vector<std::string> growing = growth.growing();
+    for (unsigned i=0; i<growing.size(); i++)
+        std::cerr << "unbounded growth: " << growing[i] << std::endl;
+    return growing.empty() ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* Monte Carlo evaluation of Normal mode balance: for each point of a parameter
+ * sweep, the reference bot plays the same seeded games, and level reached, game
+ * length, points and moves are written for every game.
+ *
+ * usage: heriswap_tune [--games N] [--threads T] [--difficulty easy|medium|hard]
+ *                      [--out file] [param=v1,v2,...] [param=from:to:step] ...
+ *   params: see GameRules::NormalTuning (pointsFactor, bonusMultiplier, limitStart,
+ *   limitDecay, limitMin, leavesBase, leavesPerLevel, timeGainPerLeaf, levelUpTimeGain)
+ *
+ * Output (default: tune.columns) is column oriented, to be mapped directly by
+ * plotting scripts: a text header
+ *     heriswap-columns 1
+ *     rows <n>
+ *     <name> <f32|u32>      (one line per column)
+ *     data
+ * followed by each column as <n> little endian values, one column after the other.
+ * A per-point summary is printed on stdout.
+ */
+
+#include "sim/SessionHost.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const float FrameDt = 1 / 60.f;
+// bot speed: time spent looking for a move (on top of animations)
+static const float BotThinkTime = 1.f;
+// Normal mode can last forever with a lucky bot
+static const float MaxGameTime = 60 * 60;
+
+///--------------------- parameters ------------------------------------------//
+struct Parameter {
+    const char* name;
+    float GameRules::NormalTuning::* asFloat;
+    unsigned int GameRules::NormalTuning::* asUnsigned;
+    int GameRules::NormalTuning::* asInt;
+};
+
+static const Parameter parameters[] = {
+    { "pointsFactor", 0, &GameRules::NormalTuning::pointsFactor, 0 },
+    { "bonusMultiplier", 0, &GameRules::NormalTuning::bonusMultiplier, 0 },
+    { "limitStart", &GameRules::NormalTuning::limitStart, 0, 0 },
+    { "limitDecay", &GameRules::NormalTuning::limitDecay, 0, 0 },
+    { "limitMin", &GameRules::NormalTuning::limitMin, 0, 0 },
+    { "leavesBase", 0, 0, &GameRules::NormalTuning::leavesBase },
+    { "leavesPerLevel", 0, 0, &GameRules::NormalTuning::leavesPerLevel },
+    { "timeGainPerLeaf", &GameRules::NormalTuning::timeGainPerLeaf, 0, 0 },
+    { "levelUpTimeGain", &GameRules::NormalTuning::levelUpTimeGain, 0, 0 },
+};
+static const unsigned ParameterCount = sizeof(parameters) / sizeof(parameters[0]);
+
+static void setParameter(GameRules::NormalTuning& t, const Parameter& p, float value) {
+    if (p.asFloat)
+        t.*p.asFloat = value;
+    else if (p.asUnsigned)
+        t.*p.asUnsigned = (unsigned int)value;
+    else
+        t.*p.asInt = (int)value;
+}
+
+static float getParameter(const GameRules::NormalTuning& t, const Parameter& p) {
+    if (p.asFloat)
+        return t.*p.asFloat;
+    else if (p.asUnsigned)
+        return (float)(t.*p.asUnsigned);
+    return (float)(t.*p.asInt);
+}
+
+struct Axis {
+    unsigned parameter;
+    std::vector<float> values;
+};
+
+// "name=1,2,3" or "name=from:to:step"
+static bool parseAxis(const std::string& arg, Axis& axis) {
+    const size_t eq = arg.find('=');
+    if (eq == std::string::npos)
+        return false;
+    const std::string name = arg.substr(0, eq), values = arg.substr(eq + 1);
+
+    axis.parameter = ParameterCount;
+    for (unsigned i=0; i<ParameterCount; i++) {
+        if (name == parameters[i].name)
+            axis.parameter = i;
+    }
+    if (axis.parameter == ParameterCount)
+        return false;
+
+    float from, to, step;
+    if (sscanf(values.c_str(), "%f:%f:%f", &from, &to, &step) == 3) {
+        if (step <= 0)
+            return false;
+        for (float v = from; v <= to + step * 0.001f; v += step)
+            axis.values.push_back(v);
+    } else {
+        std::stringstream ss(values);
+        std::string v;
+        while (std::getline(ss, v, ','))
+            axis.values.push_back(atof(v.c_str()));
+    }
+    return !axis.values.empty();
+}
+
+///--------------------- simulation ------------------------------------------//
+struct GameResult {
+    unsigned level, points, moves;
+    float length;
+};
+
+static GameResult play(const GameRules::NormalTuning& tuning, Difficulty difficulty, uint32_t seed) {
+    HostedSession s;
+    s.botRandom.seed(~seed);
+    s.thinkTime = s.untilNextMove = BotThinkTime;
+    s.finished = false;
+    s.game.tuning = tuning;
+    s.game.start(Normal, difficulty, seed);
+
+    // Normal mode clock goes back on combinations: game length is the real time
+    float length = 0;
+    while (!s.finished && length < MaxGameTime) {
+        // keep playing the same difficulty at level 10
+        if (s.game.awaitingEliteChoice())
+            s.game.eliteChoice(false);
+        s.step(FrameDt);
+        length += FrameDt;
+    }
+    GameResult r;
+    r.level = s.game.level;
+    r.points = s.game.points;
+    r.moves = s.game.moves;
+    r.length = length;
+    return r;
+}
+
+///--------------------- output ----------------------------------------------//
+template<class T>
+static void writeColumn(std::ofstream& out, const std::vector<T>& values) {
+    out.write((const char*)&values[0], values.size() * sizeof(T));
+}
+
+template<class T>
+static float quantile(std::vector<T> values, float q) {
+    std::sort(values.begin(), values.end());
+    return (float)values[(unsigned)(q * (values.size() - 1) + 0.5f)];
+}
+
+int main(int argc, char** argv) {
+    unsigned games = 200;
+    unsigned threadCount = std::thread::hardware_concurrency();
+    Difficulty difficulty = DifficultyEasy;
+    std::string outPath("tune.columns");
+    std::vector<Axis> axes;
+
+    for (int i=1; i<argc; i++) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threadCount = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (!strcmp(argv[i], "--difficulty") && i + 1 < argc) {
+            const std::string d(argv[++i]);
+            difficulty = (d == "hard") ? DifficultyHard : ((d == "medium") ? DifficultyMedium : DifficultyEasy);
+        } else {
+            Axis axis;
+            if (!parseAxis(argv[i], axis)) {
+                std::cerr << "invalid parameter sweep: '" << argv[i] << "'" << std::endl;
+                return 1;
+            }
+            axes.push_back(axis);
+        }
+    }
+    if (threadCount == 0)
+        threadCount = 1;
+    if (games == 0)
+        games = 1;
+
+    // cartesian product of the axes, the first one varying slowest
+    std::vector<GameRules::NormalTuning> points(1);
+    for (unsigned a=0; a<axes.size(); a++) {
+        std::vector<GameRules::NormalTuning> expanded;
+        for (unsigned p=0; p<points.size(); p++) {
+            for (unsigned v=0; v<axes[a].values.size(); v++) {
+                GameRules::NormalTuning t = points[p];
+                setParameter(t, parameters[axes[a].parameter], axes[a].values[v]);
+                expanded.push_back(t);
+            }
+        }
+        points.swap(expanded);
+    }
+
+    // every point plays the same seeds, so differences come from the parameters
+    const unsigned rows = points.size() * games;
+    std::vector<GameResult> results(rows);
+    std::atomic<unsigned> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t=0; t<threadCount; t++) {
+        workers.push_back(std::thread([&] () {
+            for (unsigned i = next++; i < rows; i = next++)
+                results[i] = play(points[i / games], difficulty, 1 + i % games);
+        }));
+    }
+    for (unsigned t=0; t<workers.size(); t++)
+        workers[t].join();
+
+    // columns
+    std::vector<uint32_t> pointColumn(rows), seedColumn(rows), levelColumn(rows), pointsColumn(rows), movesColumn(rows);
+    std::vector<float> lengthColumn(rows);
+    std::vector<std::vector<float> > parameterColumns(axes.size(), std::vector<float>(rows));
+    for (unsigned i=0; i<rows; i++) {
+        pointColumn[i] = i / games;
+        seedColumn[i] = 1 + i % games;
+        levelColumn[i] = results[i].level;
+        pointsColumn[i] = results[i].points;
+        movesColumn[i] = results[i].moves;
+        lengthColumn[i] = results[i].length;
+        for (unsigned a=0; a<axes.size(); a++)
+            parameterColumns[a][i] = getParameter(points[i / games], parameters[axes[a].parameter]);
+    }
+
+    std::ofstream out(outPath.c_str(), std::ios::binary);
+    out << "heriswap-columns 1\nrows " << rows << "\n";
+    out << "point u32\nseed u32\n";
+    for (unsigned a=0; a<axes.size(); a++)
+        out << parameters[axes[a].parameter].name << " f32\n";
+    out << "level u32\nlength f32\npoints u32\nmoves u32\ndata\n";
+    writeColumn(out, pointColumn);
+    writeColumn(out, seedColumn);
+    for (unsigned a=0; a<axes.size(); a++)
+        writeColumn(out, parameterColumns[a]);
+    writeColumn(out, levelColumn);
+    writeColumn(out, lengthColumn);
+    writeColumn(out, pointsColumn);
+    writeColumn(out, movesColumn);
+    if (!out) {
+        std::cerr << "can't write '" << outPath << "'" << std::endl;
+        return 1;
+    }
+
+    // summary: median and 10/90% quantiles of each point
+    for (unsigned p=0; p<points.size(); p++) {
+        std::vector<unsigned> level(levelColumn.begin() + p * games, levelColumn.begin() + (p + 1) * games);
+        std::vector<unsigned> score(pointsColumn.begin() + p * games, pointsColumn.begin() + (p + 1) * games);
+        std::vector<float> length(lengthColumn.begin() + p * games, lengthColumn.begin() + (p + 1) * games);
+
+        std::cout << "point " << p << ":";
+        for (unsigned a=0; a<axes.size(); a++)
+            std::cout << " " << parameters[axes[a].parameter].name << "=" << getParameter(points[p], parameters[axes[a].parameter]);
+        std::cout << std::endl;
+        std::cout << "  level  " << quantile(level, 0.1f) << " / " << quantile(level, 0.5f) << " / " << quantile(level, 0.9f) << std::endl;
+        std::cout << "  length " << quantile(length, 0.1f) << " / " << quantile(length, 0.5f) << " / " << quantile(length, 0.9f) << " s" << std::endl;
+        std::cout << "  points " << quantile(score, 0.1f) << " / " << quantile(score, 0.5f) << " / " << quantile(score, 0.9f) << std::endl;
+    }
+    std::cerr << rows << " games on " << threadCount << " threads, written to " << outPath << std::endl;
+    return 0;
+}
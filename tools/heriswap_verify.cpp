@@ -0,0 +1,104 @@
+/*
+    This file is part of Heriswap.
+
+    @author Soupe au Caillou - Jordane Pelloux-Prayer
+    @author Soupe au Caillou - Gautier Pelloux-Prayer
+    @author Soupe au Caillou - Pierre-Eric Pelloux-Prayer
+
+    Heriswap is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3.
+
+    Heriswap is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Heriswap.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Batch verification of submitted games: every '.session' file of a directory is
+ * replayed and a '.verdict' file is written next to it.
+ *
+ * usage: heriswap_verify <directory> [threads]
+ */
+
+#include "sim/ReplayVerifier.h"
+#include "sim/SessionLog.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+static std::vector<std::string> listSessions(const std::string& dir) {
+    std::vector<std::string> files;
+    DIR* d = opendir(dir.c_str());
+    if (!d)
+        return files;
+    while (struct dirent* entry = readdir(d)) {
+        const std::string name(entry->d_name);
+        if (endsWith(name, ".session"))
+            files.push_back(dir + "/" + name);
+    }
+    closedir(d);
+    return files;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <directory> [threads]" << std::endl;
+        return 1;
+    }
+    const std::string dir(argv[1]);
+    unsigned threadCount = (argc > 2) ? atoi(argv[2]) : std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    const std::vector<std::string> files = listSessions(dir);
+    std::vector<ReplayVerdict> verdicts(files.size());
+
+    // sessions are independent: each worker picks the next unverified one
+    std::atomic<unsigned> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t=0; t<threadCount; t++) {
+        workers.push_back(std::thread([&] () {
+            for (unsigned i = next++; i < files.size(); i = next++) {
+                SessionLog session;
+                if (!session.load(files[i])) {
+                    verdicts[i].accepted = false;
+                    verdicts[i].reason = "unreadable session";
+                    verdicts[i].eventIndex = -1;
+                    verdicts[i].points = 0;
+                    verdicts[i].time = 0;
+                    verdicts[i].level = 0;
+                } else {
+                    verdicts[i] = ReplayVerifier::verify(session);
+                }
+                std::ofstream out((files[i] + ".verdict").c_str());
+                out << ReplayVerifier::verdictToString(verdicts[i]) << std::endl;
+            }
+        }));
+    }
+    for (unsigned t=0; t<workers.size(); t++)
+        workers[t].join();
+
+    unsigned accepted = 0;
+    for (unsigned i=0; i<files.size(); i++) {
+        if (verdicts[i].accepted)
+            accepted++;
+        else
+            std::cout << files[i] << ": " << ReplayVerifier::verdictToString(verdicts[i]) << std::endl;
+    }
+    std::cout << accepted << "/" << files.size() << " sessions accepted" << std::endl;
+    return (accepted == files.size()) ? 0 : 2;
+}